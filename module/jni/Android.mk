@@ -58,6 +58,7 @@ LOCAL_SRC_FILES := \
     Dobby/source/core/codegen/codegen-x64.cc \
     Dobby/source/MemoryAllocator/CodeBuffer/CodeBufferBase.cc \
     Dobby/source/MemoryAllocator/AssemblyCodeBuilder.cc \
+    Dobby/source/MemoryAllocator/PerfMap.cc \
     Dobby/source/MemoryAllocator/MemoryAllocator.cc \
     Dobby/source/InstructionRelocation/arm/InstructionRelocationARM.cc \
     Dobby/source/InstructionRelocation/arm64/InstructionRelocationARM64.cc \
@@ -86,8 +87,10 @@ LOCAL_SRC_FILES := \
     Dobby/source/InterceptRouting/Routing/InstructionInstrument/InstructionInstrument.cc \
     Dobby/source/InterceptRouting/Routing/InstructionInstrument/RoutingImpl.cc \
     Dobby/source/InterceptRouting/Routing/InstructionInstrument/instrument_routing_handler.cc \
+    Dobby/source/Backend/UserMode/MultiThreadSupport/ThreadSupport.cpp \
     Dobby/source/InterceptRouting/Routing/FunctionInlineHook/FunctionInlineHook.cc \
     Dobby/source/InterceptRouting/Routing/FunctionInlineHook/RoutingImpl.cc \
+    Dobby/source/InterceptRouting/Routing/FunctionInlineHook/hook_stats_handler.cc \
     Dobby/source/InterceptRouting/RoutingPlugin/RoutingPlugin.cc \
     Dobby/source/dobby.cpp \
     Dobby/source/Interceptor.cpp \
@@ -104,14 +107,16 @@ ifeq ($(NEAR_BRANCH),true)
         LOCAL_SRC_FILES += \
             Dobby/source/InterceptRouting/RoutingPlugin/NearBranchTrampoline/near_trampoline_arm64.cc \
             Dobby/source/InterceptRouting/RoutingPlugin/NearBranchTrampoline/NearBranchTrampoline.cc \
-            Dobby/source/MemoryAllocator/NearMemoryAllocator.cc
+            Dobby/source/MemoryAllocator/NearMemoryAllocator.cc \
+            Dobby/source/MemoryAllocator/NearVeneerPool.cc
     endif
 endif
 
 ifeq ($(PLUGIN_SYMBOL_RESOLVER),true)
     LOCAL_C_INCLUDES += $(LOCAL_PATH)/Dobby/builtin-plugin/SymbolResolver
     LOCAL_SRC_FILES += \
-        Dobby/builtin-plugin/SymbolResolver/elf/dobby_symbol_resolver.cc
+        Dobby/builtin-plugin/SymbolResolver/elf/dobby_symbol_resolver.cc \
+        Dobby/builtin-plugin/SymbolResolver/elf/xz_decoder.cc
 endif
 
 include $(BUILD_STATIC_LIBRARY)
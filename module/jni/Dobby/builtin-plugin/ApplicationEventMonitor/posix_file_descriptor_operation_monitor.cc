@@ -19,8 +19,32 @@
 #include "dobby.h"
 #include "dobby/common.h"
 
+#if defined(EVENT_TRACE_ENABLED)
+#include "EventTrace/event_trace.h"
+#endif
+
 #define LOG_TAG "PosixFileOperationMonitor"
 
+// trace event ids, args are fd, buffer and size, decode with dobby_trace_decoder
+enum {
+  kTraceRead = 1,
+  kTraceWrite,
+  kTraceClose,
+};
+
+// traced as events once DobbyEventTraceStart ran, logged otherwise
+#if defined(EVENT_TRACE_ENABLED)
+#define TRACE_OR_LOG(event_id, fd, buf, count, fmt, ...)                                                               \
+  do {                                                                                                                 \
+    if (DobbyEventTraceStarted())                                                                                      \
+      DobbyEventTrace(event_id, fd, (uint64_t)(buf), count, 0);                                                        \
+    else                                                                                                               \
+      INFO_LOG(fmt, ##__VA_ARGS__);                                                                                    \
+  } while (0)
+#else
+#define TRACE_OR_LOG(event_id, fd, buf, count, fmt, ...) INFO_LOG(fmt, ##__VA_ARGS__)
+#endif
+
 std::unordered_map<int, const char *> *posix_file_descriptors;
 
 int (*orig_open)(const char *pathname, int flags, ...);
@@ -84,7 +108,7 @@ ssize_t (*orig_read)(int fd, void *buf, size_t count);
 ssize_t fake_read(int fd, void *buf, size_t count) {
   const char *traced_filename = get_traced_filename(fd, false);
   if (traced_filename) {
-    INFO_LOG("[-] read: %s, buffer: %p, size: %zu", traced_filename, buf, count);
+    TRACE_OR_LOG(kTraceRead, fd, buf, count, "[-] read: %s, buffer: %p, size: %zu", traced_filename, buf, count);
   }
   return orig_read(fd, buf, count);
 }
@@ -93,7 +117,7 @@ ssize_t (*orig_write)(int fd, const void *buf, size_t count);
 ssize_t fake_write(int fd, const void *buf, size_t count) {
   const char *traced_filename = get_traced_filename(fd, false);
   if (traced_filename) {
-    INFO_LOG("[-] write: %s, buffer: %p, size: %zu", traced_filename, buf, count);
+    TRACE_OR_LOG(kTraceWrite, fd, buf, count, "[-] write: %s, buffer: %p, size: %zu", traced_filename, buf, count);
   }
   return orig_write(fd, buf, count);
 }
@@ -101,7 +125,7 @@ int (*orig_close)(int fd);
 int fake_close(int fd) {
   const char *traced_filename = get_traced_filename(fd, true);
   if (traced_filename) {
-    INFO_LOG("[-] close: %s", traced_filename);
+    TRACE_OR_LOG(kTraceClose, fd, 0, 0, "[-] close: %s", traced_filename);
     free((void *)traced_filename);
   }
   return orig_close(fd);
@@ -13,6 +13,9 @@
 #include <unordered_map>
 #include <vector>
 #include <set>
+#include <algorithm>
+
+#include <pthread.h>
 
 #include "dobby.h"
 #include "dobby_symbol_resolver.h"
@@ -29,26 +32,33 @@ extern void *resolve_elf_internal_symbol(const char *library_name, const char *s
 
 #include <sys/system_properties.h>
 static int get_android_system_version() {
-  char os_version_str[PROP_VALUE_MAX + 1];
-  __system_property_get("ro.build.version.sdk", os_version_str);
-  int os_version_int = atoi(os_version_str);
+  static int os_version_int = -1;
+  if (os_version_int == -1) {
+    char os_version_str[PROP_VALUE_MAX + 1] = {0};
+    __system_property_get("ro.build.version.sdk", os_version_str);
+    os_version_int = atoi(os_version_str);
+  }
   return os_version_int;
 }
 
 static const char *get_android_linker_path() {
+  static const char *linker_path = NULL;
+  if (linker_path)
+    return linker_path;
 #if __LP64__
   if (get_android_system_version() >= Q) {
-    return (const char *)"/apex/com.android.runtime/bin/linker64";
+    linker_path = (const char *)"/apex/com.android.runtime/bin/linker64";
   } else {
-    return (const char *)"/system/bin/linker64";
+    linker_path = (const char *)"/system/bin/linker64";
   }
 #else
   if (get_android_system_version() >= Q) {
-    return (const char *)"/apex/com.android.runtime/bin/linker";
+    linker_path = (const char *)"/apex/com.android.runtime/bin/linker";
   } else {
-    return (const char *)"/system/bin/linker";
+    linker_path = (const char *)"/system/bin/linker";
   }
 #endif
+  return linker_path;
 }
 
 PUBLIC void *linker_dlopen(const char *filename, int flag) {
@@ -62,51 +72,135 @@ PUBLIC void *linker_dlopen(const char *filename, int flag) {
   return __loader_dlopen(filename, flag, (const void *)open_ptr);
 }
 
-std::vector<soinfo_t> linker_solist;
-std::vector<soinfo_t> linker_get_solist() {
-  if (!linker_solist.empty()) {
-    linker_solist.clear();
-  }
-
-  static soinfo_t (*solist_get_head)() = NULL;
-  if (!solist_get_head)
-    solist_get_head =
-        (soinfo_t(*)())resolve_elf_internal_symbol(get_android_linker_path(), "__dl__Z15solist_get_headv");
-
-  static soinfo_t (*solist_get_somain)() = NULL;
-  if (!solist_get_somain)
-    solist_get_somain =
-        (soinfo_t(*)())resolve_elf_internal_symbol(get_android_linker_path(), "__dl__Z17solist_get_somainv");
-
-  static addr_t *solist_head = NULL;
-  if (!solist_head)
-    solist_head = (addr_t *)solist_get_head();
-
-  static addr_t somain = 0;
-  if (!somain)
-    somain = (addr_t)solist_get_somain();
-
     // Generate the name for an offset.
 #define PARAM_OFFSET(type_, member_) __##type_##__##member_##__offset_
 #define STRUCT_OFFSET PARAM_OFFSET
-  int STRUCT_OFFSET(solist, next) = 0;
+
+// soinfo view, field offsets are computed once
+static addr_t *solist_head = NULL;
+static int STRUCT_OFFSET(solist, next) = -1;
+
+static bool linker_solist_init_offsets() {
+  if (STRUCT_OFFSET(solist, next) != -1)
+    return STRUCT_OFFSET(solist, next) != 0;
+
+  auto solist_get_head =
+      (soinfo_t(*)())resolve_elf_internal_symbol(get_android_linker_path(), "__dl__Z15solist_get_headv");
+  auto solist_get_somain =
+      (soinfo_t(*)())resolve_elf_internal_symbol(get_android_linker_path(), "__dl__Z17solist_get_somainv");
+  if (!solist_get_head || !solist_get_somain) {
+    ERROR_LOG("resolve solist_get_head/solist_get_somain failed");
+    STRUCT_OFFSET(solist, next) = 0;
+    return false;
+  }
+
+  solist_head = (addr_t *)solist_get_head();
+  addr_t somain = (addr_t)solist_get_somain();
+
+  STRUCT_OFFSET(solist, next) = 0;
   for (size_t i = 0; i < 1024 / sizeof(void *); i++) {
     if (*(addr_t *)((addr_t)solist_head + i * sizeof(void *)) == somain) {
       STRUCT_OFFSET(solist, next) = i * sizeof(void *);
       break;
     }
   }
+  if (STRUCT_OFFSET(solist, next) == 0) {
+    ERROR_LOG("soinfo::next offset not found");
+    return false;
+  }
+  return true;
+}
 
-  linker_solist.push_back(solist_head);
+static void linker_solist_walk(std::vector<soinfo_t> &solist) {
+  solist.clear();
+  solist.push_back(solist_head);
 
   addr_t sonext = 0;
   sonext = *(addr_t *)((addr_t)solist_head + STRUCT_OFFSET(solist, next));
   while (sonext) {
-    linker_solist.push_back((void *)sonext);
+    solist.push_back((void *)sonext);
     sonext = *(addr_t *)((addr_t)sonext + STRUCT_OFFSET(solist, next));
   }
+}
+
+// the cached solist is kept in sync by hooking the linker's solist mutators,
+// the linker calls them with g_dl_mutex held, the cache has its own lock
+static std::vector<soinfo_t> linker_solist;
+static pthread_mutex_t linker_solist_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool linker_solist_tracked = false;
+
+static void (*orig_solist_add_soinfo)(soinfo_t si);
+static void fake_solist_add_soinfo(soinfo_t si) {
+  pthread_mutex_lock(&linker_solist_lock);
+  orig_solist_add_soinfo(si);
+  if (linker_solist_tracked)
+    linker_solist.push_back(si);
+  pthread_mutex_unlock(&linker_solist_lock);
+}
+
+static bool (*orig_solist_remove_soinfo)(soinfo_t si);
+static bool fake_solist_remove_soinfo(soinfo_t si) {
+  pthread_mutex_lock(&linker_solist_lock);
+  bool ret = orig_solist_remove_soinfo(si);
+  if (ret && linker_solist_tracked) {
+    auto it = std::find(linker_solist.begin(), linker_solist.end(), si);
+    if (it != linker_solist.end())
+      linker_solist.erase(it);
+  }
+  pthread_mutex_unlock(&linker_solist_lock);
+  return ret;
+}
+
+static bool linker_solist_install_tracker() {
+  void *solist_add_soinfo_ptr =
+      resolve_elf_internal_symbol(get_android_linker_path(), "__dl__Z17solist_add_soinfoP6soinfo");
+  void *solist_remove_soinfo_ptr =
+      resolve_elf_internal_symbol(get_android_linker_path(), "__dl__Z20solist_remove_soinfoP6soinfo");
+  if (!solist_add_soinfo_ptr || !solist_remove_soinfo_ptr) {
+    ERROR_LOG("resolve solist_add_soinfo/solist_remove_soinfo failed, fallback to full walk");
+    return false;
+  }
+
+  if (DobbyHook(solist_add_soinfo_ptr, (void *)fake_solist_add_soinfo, (void **)&orig_solist_add_soinfo) != 0)
+    return false;
+  if (DobbyHook(solist_remove_soinfo_ptr, (void *)fake_solist_remove_soinfo, (void **)&orig_solist_remove_soinfo) !=
+      0) {
+    DobbyDestroy(solist_add_soinfo_ptr);
+    return false;
+  }
+  return true;
+}
+
+static bool linker_solist_hooked = false;
+
+bool linker_solist_track() {
+  if (linker_solist_hooked)
+    return true;
+  if (!linker_solist_init_offsets())
+    return false;
+  linker_solist_hooked = linker_solist_install_tracker();
+  return linker_solist_hooked;
+}
+
+std::vector<soinfo_t> linker_get_solist() {
+  std::vector<soinfo_t> solist;
+  if (!linker_solist_init_offsets())
+    return solist;
+
+  if (!linker_solist_hooked) {
+    linker_solist_walk(solist);
+    return solist;
+  }
 
-  return linker_solist;
+  pthread_mutex_lock(&linker_solist_lock);
+  if (!linker_solist_tracked) {
+    // mutators are blocked on the lock, the walk sees a stable list
+    linker_solist_walk(linker_solist);
+    linker_solist_tracked = true;
+  }
+  solist = linker_solist;
+  pthread_mutex_unlock(&linker_solist_lock);
+  return solist;
 }
 
 char *linker_soinfo_get_realpath(soinfo_t soinfo) {
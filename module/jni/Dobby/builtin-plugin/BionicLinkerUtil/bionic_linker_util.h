@@ -1,6 +1,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -14,6 +15,10 @@ char *linker_soinfo_get_realpath(soinfo_t soinfo);
 
 uintptr_t linker_soinfo_to_handle(soinfo_t soinfo);
 
+// cache the solist and keep it in sync by hooking the linker's solist mutators,
+// linker_iterate_soinfo walks the whole list every time otherwise
+bool linker_solist_track();
+
 void linker_iterate_soinfo(int (*cb)(soinfo_t soinfo));
 
 void linker_disable_namespace_restriction();
@@ -0,0 +1,248 @@
+#include "EventTrace/event_trace.h"
+#include "dobby/common.h"
+
+#include "PlatformUnifiedInterface/platform.h"
+
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <pthread.h>
+
+#undef LOG_TAG
+#define LOG_TAG "DobbyEventTrace"
+
+// records per write of the drainer
+#define TRACE_BATCH_RECORDS 256
+
+// single producer ring, the owner thread appends at head and the drainer consumes from tail
+typedef struct TraceRing {
+  alignas(64) uint64_t head;
+  uint64_t dropped;
+
+  alignas(64) uint64_t tail;
+
+  uint32_t mask;
+  uint32_t tid;
+  // the owner thread exited, a new thread takes the ring over once it is drained
+  int retired;
+  struct TraceRing *next;
+  DobbyTraceRecord *records;
+} TraceRing;
+
+// rings are never freed, only pushed to the list and reused
+static TraceRing *rings_ = nullptr;
+
+static bool tracing_ = false;
+static int trace_fd_ = -1;
+static uint32_t ring_records_ = 0;
+static uint32_t flush_interval_ms_ = 0;
+
+static bool drainer_running_ = false;
+static pthread_t drainer_;
+
+static thread_local bool is_drainer_ = false;
+
+// plain data, a thread_local with a destructor would register a thread exit handler which keeps the library loaded
+static thread_local TraceRing *thread_ring_ = nullptr;
+
+// retires the ring of the thread at exit
+static pthread_key_t ring_key_;
+static pthread_once_t ring_key_once_ = PTHREAD_ONCE_INIT;
+static bool ring_key_created_ = false;
+
+static void retire_ring(void *value) {
+  auto ring = (TraceRing *)value;
+  __atomic_store_n(&ring->retired, 1, __ATOMIC_RELEASE);
+}
+
+static void create_ring_key() {
+  ring_key_created_ = pthread_key_create(&ring_key_, retire_ring) == 0;
+}
+
+// no exiting thread may call into the unloaded library
+__attribute__((destructor)) static void delete_ring_key() {
+  if (ring_key_created_)
+    pthread_key_delete(ring_key_);
+}
+
+static TraceRing *acquire_ring() {
+  pthread_once(&ring_key_once_, create_ring_key);
+  if (!ring_key_created_)
+    return nullptr;
+
+  uint32_t tid = (uint32_t)base::ThreadInterface::CurrentId();
+
+  for (TraceRing *ring = __atomic_load_n(&rings_, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+    int retired = 1;
+    if (__atomic_load_n(&ring->retired, __ATOMIC_ACQUIRE) != 1)
+      continue;
+    if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) != ring->head)
+      continue;
+    if (__atomic_compare_exchange_n(&ring->retired, &retired, 0, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+      ring->tid = tid;
+      pthread_setspecific(ring_key_, ring);
+      return ring;
+    }
+  }
+
+  // not malloc, which may be traced itself
+  size_t records_size = (size_t)ring_records_ * sizeof(DobbyTraceRecord);
+  size_t size = ALIGN_CEIL(sizeof(TraceRing) + records_size, OSMemory::PageSize());
+  auto ring = (TraceRing *)OSMemory::Allocate(size, kReadWrite);
+  if (ring == nullptr)
+    return nullptr;
+  ring->mask = ring_records_ - 1;
+  ring->tid = tid;
+  ring->records = (DobbyTraceRecord *)(ring + 1);
+
+  ring->next = __atomic_load_n(&rings_, __ATOMIC_RELAXED);
+  while (!__atomic_compare_exchange_n(&rings_, &ring->next, ring, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    ;
+  pthread_setspecific(ring_key_, ring);
+  return ring;
+}
+
+PUBLIC void DobbyEventTrace(uint32_t event_id, uint64_t arg0, uint64_t arg1, uint64_t arg2, uint64_t arg3) {
+  if (!__atomic_load_n(&tracing_, __ATOMIC_RELAXED) || is_drainer_)
+    return;
+
+  TraceRing *ring = thread_ring_;
+  if (ring == nullptr) {
+    ring = acquire_ring();
+    if (ring == nullptr)
+      return;
+    thread_ring_ = ring;
+  }
+
+  uint64_t head = ring->head;
+  if (head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) > ring->mask) {
+    __atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+    return;
+  }
+
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  DobbyTraceRecord *record = &ring->records[head & ring->mask];
+  record->timestamp_ns = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+  record->event_id = event_id;
+  record->tid = ring->tid;
+  record->args[0] = arg0;
+  record->args[1] = arg1;
+  record->args[2] = arg2;
+  record->args[3] = arg3;
+  __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+static bool write_all(int fd, const void *buffer, size_t size) {
+  auto p = (const uint8_t *)buffer;
+  while (size) {
+    ssize_t n = write(fd, p, size);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    p += n;
+    size -= n;
+  }
+  return true;
+}
+
+static void flush_batch(DobbyTraceRecord *batch, uint32_t count) {
+  if (!write_all(trace_fd_, batch, count * sizeof(DobbyTraceRecord)))
+    ERROR_LOG("write %d records failed: %s", count, strerror(errno));
+}
+
+static void drain_rings() {
+  DobbyTraceRecord batch[TRACE_BATCH_RECORDS];
+  uint32_t count = 0;
+
+  for (TraceRing *ring = __atomic_load_n(&rings_, __ATOMIC_ACQUIRE); ring; ring = ring->next) {
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    uint64_t tail = ring->tail;
+    while (tail != head) {
+      batch[count++] = ring->records[tail & ring->mask];
+      tail++;
+      if (count == TRACE_BATCH_RECORDS) {
+        flush_batch(batch, count);
+        count = 0;
+      }
+    }
+    // the records are copied out, the owner may overwrite them
+    __atomic_store_n(&ring->tail, tail, __ATOMIC_RELEASE);
+  }
+
+  if (count)
+    flush_batch(batch, count);
+}
+
+static void *drainer_main(void *) {
+  is_drainer_ = true;
+  base::ThreadInterface::SetName("dobby-trace");
+
+  struct timespec interval;
+  interval.tv_sec = flush_interval_ms_ / 1000;
+  interval.tv_nsec = (flush_interval_ms_ % 1000) * 1000000;
+  while (__atomic_load_n(&drainer_running_, __ATOMIC_ACQUIRE)) {
+    drain_rings();
+    nanosleep(&interval, nullptr);
+  }
+  drain_rings();
+  return nullptr;
+}
+
+PUBLIC int DobbyEventTraceStart(int fd, uint32_t records_per_thread, uint32_t flush_interval_ms) {
+  if (__atomic_load_n(&tracing_, __ATOMIC_ACQUIRE)) {
+    ERROR_LOG("already tracing to fd %d", trace_fd_);
+    return -1;
+  }
+
+  DobbyTraceHeader header;
+  memcpy(header.magic, DOBBY_TRACE_MAGIC, sizeof(header.magic));
+  header.version = DOBBY_TRACE_VERSION;
+  header.record_size = sizeof(DobbyTraceRecord);
+  if (!write_all(fd, &header, sizeof(header))) {
+    ERROR_LOG("write trace header to fd %d failed: %s", fd, strerror(errno));
+    return -1;
+  }
+
+  // rings created by an earlier start keep their size
+  uint32_t records = 16;
+  while (records < records_per_thread && records < (1u << 24))
+    records <<= 1;
+  ring_records_ = records;
+  flush_interval_ms_ = flush_interval_ms ? flush_interval_ms : 1;
+  trace_fd_ = fd;
+
+  __atomic_store_n(&drainer_running_, true, __ATOMIC_RELEASE);
+  if (pthread_create(&drainer_, nullptr, drainer_main, nullptr) != 0) {
+    ERROR_LOG("create drainer thread failed");
+    __atomic_store_n(&drainer_running_, false, __ATOMIC_RELEASE);
+    return -1;
+  }
+  __atomic_store_n(&tracing_, true, __ATOMIC_RELEASE);
+  return 0;
+}
+
+PUBLIC void DobbyEventTraceStop() {
+  if (!__atomic_load_n(&tracing_, __ATOMIC_ACQUIRE))
+    return;
+
+  // an event racing with stop may stay in its ring until the next start
+  __atomic_store_n(&tracing_, false, __ATOMIC_RELEASE);
+  __atomic_store_n(&drainer_running_, false, __ATOMIC_RELEASE);
+  pthread_join(drainer_, nullptr);
+}
+
+PUBLIC int DobbyEventTraceStarted() {
+  return __atomic_load_n(&tracing_, __ATOMIC_RELAXED) ? 1 : 0;
+}
+
+PUBLIC uint64_t DobbyEventTraceDropped() {
+  uint64_t dropped = 0;
+  for (TraceRing *ring = __atomic_load_n(&rings_, __ATOMIC_ACQUIRE); ring; ring = ring->next)
+    dropped += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+  return dropped;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DOBBY_TRACE_MAGIC "DBYTRACE"
+#define DOBBY_TRACE_VERSION 1
+#define DOBBY_TRACE_ARGS 4
+
+// trace stream header, followed by records, both in native byte order
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t record_size;
+} DobbyTraceHeader;
+
+typedef struct {
+  // CLOCK_MONOTONIC
+  uint64_t timestamp_ns;
+  uint32_t event_id;
+  uint32_t tid;
+  uint64_t args[DOBBY_TRACE_ARGS];
+} DobbyTraceRecord;
+
+// start tracing to fd, a file or a socket. Each thread appends to its own ring of records_per_thread records (rounded up
+// to a power of two), a drainer thread writes the rings to fd in batches every flush_interval_ms
+// @Return: -1 if already started
+int DobbyEventTraceStart(int fd, uint32_t records_per_thread, uint32_t flush_interval_ms);
+
+// stop the drainer after a last drain, fd is left open
+void DobbyEventTraceStop();
+
+// append a record to the calling thread's ring without locks or allocation once the ring exists, a record is dropped
+// if the ring is full or tracing is stopped. Events of the drainer thread are ignored, such as a traced write of fd
+void DobbyEventTrace(uint32_t event_id, uint64_t arg0, uint64_t arg1, uint64_t arg2, uint64_t arg3);
+
+// 1 between start and stop
+int DobbyEventTraceStarted();
+
+// records dropped on full rings
+uint64_t DobbyEventTraceDropped();
+
+#ifdef __cplusplus
+}
+#endif
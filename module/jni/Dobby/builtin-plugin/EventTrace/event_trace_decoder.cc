@@ -0,0 +1,115 @@
+// offline decoder of a DobbyEventTrace stream, build for the host with
+//   c++ -std=c++11 -I builtin-plugin builtin-plugin/EventTrace/event_trace_decoder.cc -o dobby_trace_decoder
+// the stream must come from a target of the same byte order
+#include "EventTrace/event_trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+static void usage(const char *self) {
+  fprintf(stderr, "usage: %s [-n names] [-u] trace\n", self);
+  fprintf(stderr, "  -n names  event names, one \"<event_id> <name>\" per line\n");
+  fprintf(stderr, "  -u        keep the drain order instead of sorting by timestamp\n");
+}
+
+static bool load_names(const char *path, std::map<uint32_t, std::string> &names) {
+  FILE *fp = fopen(path, "r");
+  if (!fp)
+    return false;
+  char line[256];
+  while (fgets(line, sizeof(line), fp)) {
+    char *end = nullptr;
+    uint32_t id = (uint32_t)strtoul(line, &end, 0);
+    if (end == line)
+      continue;
+    while (*end == ' ' || *end == '\t')
+      end++;
+    end[strcspn(end, "\r\n")] = 0;
+    names[id] = end;
+  }
+  fclose(fp);
+  return true;
+}
+
+int main(int argc, char **argv) {
+  const char *names_path = nullptr;
+  const char *trace_path = nullptr;
+  bool sort = true;
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+      names_path = argv[++i];
+    } else if (!strcmp(argv[i], "-u")) {
+      sort = false;
+    } else if (argv[i][0] != '-' && !trace_path) {
+      trace_path = argv[i];
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+  if (!trace_path) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  std::map<uint32_t, std::string> names;
+  if (names_path && !load_names(names_path, names)) {
+    fprintf(stderr, "can't read %s\n", names_path);
+    return 1;
+  }
+
+  FILE *fp = fopen(trace_path, "rb");
+  if (!fp) {
+    fprintf(stderr, "can't read %s\n", trace_path);
+    return 1;
+  }
+  DobbyTraceHeader header;
+  if (fread(&header, sizeof(header), 1, fp) != 1 || memcmp(header.magic, DOBBY_TRACE_MAGIC, sizeof(header.magic))) {
+    fprintf(stderr, "%s is not a trace\n", trace_path);
+    return 1;
+  }
+  if (header.version != DOBBY_TRACE_VERSION || header.record_size != sizeof(DobbyTraceRecord)) {
+    fprintf(stderr, "unsupported trace version %u, record size %u\n", header.version, header.record_size);
+    return 1;
+  }
+
+  std::vector<DobbyTraceRecord> records;
+  DobbyTraceRecord record;
+  while (fread(&record, sizeof(record), 1, fp) == 1)
+    records.push_back(record);
+  fclose(fp);
+
+  // each ring is drained in order, rings interleave by batch
+  if (sort) {
+    std::stable_sort(records.begin(), records.end(), [](const DobbyTraceRecord &a, const DobbyTraceRecord &b) {
+      return a.timestamp_ns < b.timestamp_ns;
+    });
+  }
+
+  uint64_t base = 0;
+  for (auto &r : records) {
+    if (!base || r.timestamp_ns < base)
+      base = r.timestamp_ns;
+  }
+  for (auto &r : records) {
+    uint64_t t = r.timestamp_ns - base;
+    auto name = names.find(r.event_id);
+    printf("%6" PRIu64 ".%09" PRIu64 " %6u ", t / 1000000000, t % 1000000000, r.tid);
+    if (name != names.end())
+      printf("%-16s", name->second.c_str());
+    else
+      printf("%-16u", r.event_id);
+    for (int i = 0; i < DOBBY_TRACE_ARGS; i++)
+      printf(" 0x%" PRIx64, r.args[i]);
+    printf("\n");
+  }
+  fprintf(stderr, "%zu records\n", records.size());
+  return 0;
+}
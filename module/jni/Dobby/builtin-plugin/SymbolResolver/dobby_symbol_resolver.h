@@ -1,5 +1,7 @@
 #pragma once
 
+#include "dobby.h"
+
 #if defined(BUILDING_INTERNAL)
 #include "macho/dobby_symbol_resolver_priv.h"
 #endif
@@ -10,6 +12,14 @@ extern "C" {
 
 void *DobbySymbolResolver(const char *image_name, const char *symbol_name);
 
+int DobbySymbolResolverBatch(const char *image_name, const char **symbol_names, void **out, int count);
+
+int DobbySymbolResolverMatch(const char *image_name, const char *pattern, DobbySymbolMatch *matches, int max_count);
+
+void dobby_enable_parallel_symbol_resolver(int worker_count);
+
+void dobby_disable_parallel_symbol_resolver();
+
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -7,10 +7,18 @@
 #include <string.h>
 
 #include "mmap_file_util.h"
+#include "xz_decoder.h"
 
 #include "PlatformUtil/ProcessRuntimeUtility.h"
 
 #include <vector>
+#include <string>
+#include <unordered_set>
+#include <algorithm>
+#include <deque>
+#include <atomic>
+
+#include <pthread.h>
 
 #undef LOG_TAG
 #define LOG_TAG "DobbySymbolResolver"
@@ -24,9 +32,11 @@ typedef struct elf_ctx {
   ElfW(Shdr) * dynsym_sh_;
 
   const char *strtab_;
+  size_t strtab_size_;
   ElfW(Sym) * symtab_;
 
   const char *dynstrtab_;
+  size_t dynstrtab_size_;
   ElfW(Sym) * dynsymtab_;
 
   size_t nbucket_;
@@ -40,6 +50,13 @@ typedef struct elf_ctx {
   uint32_t gnu_maskwords_;
   uint32_t gnu_shift2_;
   ElfW(Addr) * gnu_bloom_filter_;
+
+  // MiniDebugInfo, xz compressed elf with the local symbols
+  const uint8_t *gnu_debugdata_;
+  size_t gnu_debugdata_size_;
+
+  const uint8_t *build_id_;
+  size_t build_id_size_;
 } elf_ctx_t;
 
 static void get_syms(ElfW(Ehdr) * header, ElfW(Sym) * *symtab_ptr, char **strtab_ptr, int *count_ptr) {
@@ -121,6 +138,7 @@ int elf_ctx_init(elf_ctx_t *ctx, void *header_) {
       } else if (shdr[i].sh_type == SHT_STRTAB && strcmp(shstrtab + shdr[i].sh_name, ".strtab") == 0) {
         str_sh = &shdr[i];
         ctx->strtab_ = (const char *)(ehdr_addr + shdr[i].sh_offset);
+        ctx->strtab_size_ = shdr[i].sh_size;
       } else if (shdr[i].sh_type == SHT_DYNSYM) {
         dynsym_sh = &shdr[i];
         ctx->dynsym_sh_ = dynsym_sh;
@@ -128,6 +146,16 @@ int elf_ctx_init(elf_ctx_t *ctx, void *header_) {
       } else if (shdr[i].sh_type == SHT_STRTAB && strcmp(shstrtab + shdr[i].sh_name, ".dynstr") == 0) {
         dynstr_sh = &shdr[i];
         ctx->dynstrtab_ = (const char *)(ehdr_addr + shdr[i].sh_offset);
+        ctx->dynstrtab_size_ = shdr[i].sh_size;
+      } else if (shdr[i].sh_type == SHT_PROGBITS && strcmp(shstrtab + shdr[i].sh_name, ".gnu_debugdata") == 0) {
+        ctx->gnu_debugdata_ = (const uint8_t *)(ehdr_addr + shdr[i].sh_offset);
+        ctx->gnu_debugdata_size_ = shdr[i].sh_size;
+      } else if (shdr[i].sh_type == SHT_NOTE && strcmp(shstrtab + shdr[i].sh_name, ".note.gnu.build-id") == 0) {
+        auto note = (ElfW(Nhdr) *)(ehdr_addr + shdr[i].sh_offset);
+        if (note->n_type == NT_GNU_BUILD_ID) {
+          ctx->build_id_ = (const uint8_t *)note + sizeof(ElfW(Nhdr)) + ALIGN_CEIL(note->n_namesz, 4);
+          ctx->build_id_size_ = note->n_descsz;
+        }
       }
     }
   }
@@ -135,81 +163,827 @@ int elf_ctx_init(elf_ctx_t *ctx, void *header_) {
   return 0;
 }
 
-static void *iterate_symbol_table_impl(const char *symbol_name, ElfW(Sym) * symtab, const char *strtab, int count) {
-  for (int i = 0; i < count; ++i) {
+typedef struct symbol_query {
+  const char *name;
+  size_t len;
+  // the first 4 bytes of the name, used as word compare prefilter
+  uint32_t head;
+} symbol_query_t;
+
+static void symbol_query_init(symbol_query_t *query, const char *name) {
+  query->name = name;
+  query->len = strlen(name);
+  query->head = 0;
+  memcpy(&query->head, name, query->len < sizeof(uint32_t) ? query->len : sizeof(uint32_t));
+}
+
+// reject by the terminator at the name length and the first word before the full compare
+static void *iterate_symbol_table_impl(symbol_query_t *query, ElfW(Sym) * symtab, const char *strtab,
+                                       size_t strtab_size, size_t count, std::atomic<bool> *cancel) {
+  size_t len = query->len;
+  for (size_t i = 0; i < count; ++i) {
+    if (cancel && (i & 0xFFF) == 0 && cancel->load(std::memory_order_relaxed))
+      return NULL;
+
     ElfW(Sym) *sym = symtab + i;
-    const char *symbol_name_ = strtab + sym->st_name;
-    if (strcmp(symbol_name_, symbol_name) == 0) {
-      return (void *)sym->st_value;
+    size_t name_off = sym->st_name;
+    if (name_off + len >= strtab_size)
+      continue;
+
+    const char *name = strtab + name_off;
+    if (name[len] != 0)
+      continue;
+
+    if (len >= sizeof(uint32_t)) {
+      uint32_t head;
+      memcpy(&head, name, sizeof(uint32_t));
+      if (head != query->head || memcmp(name + sizeof(uint32_t), query->name + sizeof(uint32_t), len - sizeof(uint32_t)))
+        continue;
+    } else if (memcmp(name, query->name, len)) {
+      continue;
     }
+
+    if (sym->st_shndx == SHN_UNDEF || sym->st_value == 0)
+      continue;
+    return (void *)sym->st_value;
   }
   return NULL;
 }
 
-void *elf_ctx_iterate_symbol_table(elf_ctx_t *ctx, const char *symbol_name) {
+// ================================================================
+// MiniDebugInfo
+
+static inline uint32_t elf_gnu_hash(const char *name) {
+  uint32_t h = 5381;
+  for (const uint8_t *p = (const uint8_t *)name; *p; p++)
+    h = (h << 5) + h + *p;
+  return h;
+}
+
+// decompressed MiniDebugInfo kept in memory, the least recently used unreferenced ones are dropped beyond it
+#define MINI_DEBUG_INFO_CACHE_MAX 8
+
+// modules known to the cache with their failures, the least recently used unreferenced ones are forgotten beyond it
+#define MINI_DEBUG_INFO_ENTRY_MAX 64
+
+typedef enum { kMiniDebugInfoNotLoaded, kMiniDebugInfoLoaded, kMiniDebugInfoFailed } mini_debug_info_state_t;
+
+typedef struct mini_debug_info {
+  std::string key;
+
+  // decompression of the module, the state is written holding both locks
+  pthread_mutex_t lock;
+  mini_debug_info_state_t state;
+  // lookups using the symbol table, a referenced entry is never dropped
+  int refs;
+  uint64_t last_use;
+
+  // decompressed elf, keep it alive for the symbol table
+  std::vector<uint8_t> elf;
+
+  ElfW(Sym) * symtab;
+  const char *strtab;
+  size_t strtab_size;
+  size_t count;
+
+  // hash index of the symbol table, index + 1, 0 is the end
+  std::vector<uint32_t> hashes;
+  std::vector<uint32_t> buckets;
+  std::vector<uint32_t> chain;
+} mini_debug_info_t;
+
+// the list and the references, decompression only holds the lock of its module
+static std::vector<mini_debug_info_t *> mini_debug_info_cache;
+static uint64_t mini_debug_info_clock = 0;
+static pthread_mutex_t mini_debug_info_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void mini_debug_info_build_index(mini_debug_info_t *info) {
+  size_t nbucket = 16;
+  while (nbucket < info->count)
+    nbucket <<= 1;
+
+  info->hashes.resize(info->count);
+  info->buckets.assign(nbucket, 0);
+  info->chain.assign(info->count, 0);
+  for (size_t i = 0; i < info->count; i++) {
+    ElfW(Sym) *sym = info->symtab + i;
+    if (sym->st_name == 0 || sym->st_shndx == SHN_UNDEF || sym->st_value == 0)
+      continue;
+    uint32_t hash = elf_gnu_hash(info->strtab + sym->st_name);
+    info->hashes[i] = hash;
+    info->chain[i] = info->buckets[hash & (nbucket - 1)];
+    info->buckets[hash & (nbucket - 1)] = i + 1;
+  }
+}
+
+static bool mini_debug_info_load(mini_debug_info_t *info, elf_ctx_t *ctx, const char *path) {
+  if (!xz_decompress(ctx->gnu_debugdata_, ctx->gnu_debugdata_size_, info->elf) || info->elf.size() < sizeof(ElfW(Ehdr)) ||
+      memcmp(info->elf.data(), ELFMAG, SELFMAG) != 0) {
+    ERROR_LOG("decompress .gnu_debugdata of %s failed", path);
+    std::vector<uint8_t>().swap(info->elf);
+    return false;
+  }
+
+  elf_ctx_t debug_ctx;
+  memset(&debug_ctx, 0, sizeof(elf_ctx_t));
+  elf_ctx_init(&debug_ctx, info->elf.data());
+  if (!debug_ctx.symtab_ || !debug_ctx.strtab_) {
+    std::vector<uint8_t>().swap(info->elf);
+    return false;
+  }
+
+  info->symtab = debug_ctx.symtab_;
+  info->strtab = debug_ctx.strtab_;
+  info->strtab_size = debug_ctx.strtab_size_;
+  info->count = debug_ctx.sym_sh_->sh_size / sizeof(ElfW(Sym));
+  mini_debug_info_build_index(info);
+
+  DEBUG_LOG("load .gnu_debugdata of %s, %d symbols", path, (int)info->count);
+  return true;
+}
+
+// drop the least recently used unreferenced symbol tables beyond the cache size
+static void mini_debug_info_trim_locked() {
+  for (;;) {
+    int loaded = 0;
+    mini_debug_info_t *victim = NULL;
+    for (auto info : mini_debug_info_cache) {
+      if (info->state != kMiniDebugInfoLoaded)
+        continue;
+      loaded++;
+      if (info->refs == 0 && (!victim || info->last_use < victim->last_use))
+        victim = info;
+    }
+    if (loaded <= MINI_DEBUG_INFO_CACHE_MAX || !victim)
+      return;
+
+    victim->state = kMiniDebugInfoNotLoaded;
+    victim->symtab = NULL;
+    victim->strtab = NULL;
+    victim->strtab_size = 0;
+    victim->count = 0;
+    std::vector<uint8_t>().swap(victim->elf);
+    std::vector<uint32_t>().swap(victim->hashes);
+    std::vector<uint32_t>().swap(victim->buckets);
+    std::vector<uint32_t>().swap(victim->chain);
+  }
+}
+
+static void mini_debug_info_forget_locked() {
+  while (mini_debug_info_cache.size() > MINI_DEBUG_INFO_ENTRY_MAX) {
+    auto victim = mini_debug_info_cache.end();
+    for (auto iter = mini_debug_info_cache.begin(); iter != mini_debug_info_cache.end(); iter++) {
+      if ((*iter)->refs == 0 && (victim == mini_debug_info_cache.end() || (*iter)->last_use < (*victim)->last_use))
+        victim = iter;
+    }
+    if (victim == mini_debug_info_cache.end())
+      return;
+
+    pthread_mutex_destroy(&(*victim)->lock);
+    delete *victim;
+    mini_debug_info_cache.erase(victim);
+  }
+}
+
+static void mini_debug_info_release(mini_debug_info_t *info) {
+  pthread_mutex_lock(&mini_debug_info_cache_lock);
+  info->refs--;
+  mini_debug_info_trim_locked();
+  mini_debug_info_forget_locked();
+  pthread_mutex_unlock(&mini_debug_info_cache_lock);
+}
+
+// the MiniDebugInfo symbol table of a module, decompressed once per build-id while cached, release it after use
+static mini_debug_info_t *mini_debug_info_acquire(elf_ctx_t *ctx, const char *path) {
+  if (!ctx->gnu_debugdata_)
+    return NULL;
+
+  std::string key;
+  if (ctx->build_id_) {
+    char hex[3];
+    for (size_t i = 0; i < ctx->build_id_size_; i++) {
+      snprintf(hex, sizeof(hex), "%02x", ctx->build_id_[i]);
+      key += hex;
+    }
+  } else {
+    key = path;
+  }
+
+  pthread_mutex_lock(&mini_debug_info_cache_lock);
+  mini_debug_info_t *info = NULL;
+  for (auto cached : mini_debug_info_cache) {
+    if (cached->key == key) {
+      info = cached;
+      break;
+    }
+  }
+  if (!info) {
+    info = new mini_debug_info_t();
+    info->key = key;
+    pthread_mutex_init(&info->lock, NULL);
+    info->state = kMiniDebugInfoNotLoaded;
+    info->refs = 0;
+    info->symtab = NULL;
+    mini_debug_info_cache.push_back(info);
+  }
+  info->refs++;
+  info->last_use = ++mini_debug_info_clock;
+  pthread_mutex_unlock(&mini_debug_info_cache_lock);
+
+  // the failure is kept too, never decompress twice while the module is known
+  pthread_mutex_lock(&info->lock);
+  mini_debug_info_state_t state = info->state;
+  if (state == kMiniDebugInfoNotLoaded) {
+    state = mini_debug_info_load(info, ctx, path) ? kMiniDebugInfoLoaded : kMiniDebugInfoFailed;
+    pthread_mutex_lock(&mini_debug_info_cache_lock);
+    info->state = state;
+    pthread_mutex_unlock(&mini_debug_info_cache_lock);
+  }
+  pthread_mutex_unlock(&info->lock);
+
+  if (state != kMiniDebugInfoLoaded) {
+    mini_debug_info_release(info);
+    return NULL;
+  }
+  return info;
+}
+
+static void *mini_debug_info_lookup(mini_debug_info_t *info, const char *symbol_name) {
+  uint32_t hash = elf_gnu_hash(symbol_name);
+  uint32_t ndx = info->buckets[hash & (info->buckets.size() - 1)];
+  for (; ndx; ndx = info->chain[ndx - 1]) {
+    ElfW(Sym) *sym = info->symtab + ndx - 1;
+    if (info->hashes[ndx - 1] == hash && strcmp(info->strtab + sym->st_name, symbol_name) == 0)
+      return (void *)sym->st_value;
+  }
+  return NULL;
+}
+
+void *elf_ctx_iterate_symbol_table(elf_ctx_t *ctx, symbol_query_t *query, std::atomic<bool> *cancel) {
   void *result = NULL;
   if (ctx->symtab_ && ctx->strtab_) {
     size_t count = ctx->sym_sh_->sh_size / sizeof(ElfW(Sym));
-    result = iterate_symbol_table_impl(symbol_name, ctx->symtab_, ctx->strtab_, count);
+    result = iterate_symbol_table_impl(query, ctx->symtab_, ctx->strtab_, ctx->strtab_size_, count, cancel);
     if (result)
       return result;
   }
 
   if (ctx->dynsymtab_ && ctx->dynstrtab_) {
     size_t count = ctx->dynsym_sh_->sh_size / sizeof(ElfW(Sym));
-    result = iterate_symbol_table_impl(symbol_name, ctx->dynsymtab_, ctx->dynstrtab_, count);
+    result = iterate_symbol_table_impl(query, ctx->dynsymtab_, ctx->dynstrtab_, ctx->dynstrtab_size_, count, cancel);
     if (result)
       return result;
   }
   return NULL;
 }
 
+static void *elf_ctx_lookup_mini_debug_info(elf_ctx_t *ctx, symbol_query_t *query, const char *path) {
+  auto mini_debug_info = mini_debug_info_acquire(ctx, path);
+  if (!mini_debug_info)
+    return NULL;
+  void *result = mini_debug_info_lookup(mini_debug_info, query->name);
+  mini_debug_info_release(mini_debug_info);
+  return result;
+}
+
+// the regular symbol tables of all modules are searched before any MiniDebugInfo is decompressed
+typedef enum { kResolveSymbolTable, kResolveMiniDebugInfo } resolve_pass_t;
+
+static void *resolve_elf_module_symbol(RuntimeModule *module, symbol_query_t *query, resolve_pass_t pass,
+                                       std::atomic<bool> *cancel) {
+  if (!module->load_address)
+    return NULL;
+
+  auto mmapFileMng = MmapFileManager(module->path);
+  auto file_mem = mmapFileMng.map();
+  if (!file_mem)
+    return NULL;
+
+  elf_ctx_t ctx;
+  memset(&ctx, 0, sizeof(elf_ctx_t));
+  elf_ctx_init(&ctx, file_mem);
+
+  void *result = NULL;
+  if (pass == kResolveSymbolTable)
+    result = elf_ctx_iterate_symbol_table(&ctx, query, cancel);
+  else
+    result = elf_ctx_lookup_mini_debug_info(&ctx, query, module->path);
+  if (result)
+    result = (void *)((addr_t)result + (addr_t)module->load_address - ((addr_t)file_mem - (addr_t)ctx.load_bias));
+  return result;
+}
+
+// ================================================================
+// parallel resolve
+
+static int parallel_resolve_worker_count = 0;
+
+PUBLIC void dobby_enable_parallel_symbol_resolver(int worker_count) {
+  parallel_resolve_worker_count = worker_count;
+}
+
+PUBLIC void dobby_disable_parallel_symbol_resolver() {
+  parallel_resolve_worker_count = 0;
+}
+
+typedef struct parallel_resolve_ctx {
+  tinystl::vector<RuntimeModule> *modules;
+  symbol_query_t *query;
+  resolve_pass_t pass;
+
+  // next module to scan
+  std::atomic<size_t> next;
+
+  // the first hit cancels the other workers
+  std::atomic<bool> found;
+  void *result;
+} parallel_resolve_ctx_t;
+
+static void *parallel_resolve_worker(void *arg) {
+  auto ctx = (parallel_resolve_ctx_t *)arg;
+  while (!ctx->found.load(std::memory_order_relaxed)) {
+    size_t i = ctx->next.fetch_add(1);
+    if (i >= ctx->modules->size())
+      break;
+
+    void *result = resolve_elf_module_symbol(&(*ctx->modules)[i], ctx->query, ctx->pass, &ctx->found);
+    if (result) {
+      bool expected = false;
+      if (ctx->found.compare_exchange_strong(expected, true))
+        ctx->result = result;
+      break;
+    }
+  }
+  return NULL;
+}
+
+static void *resolve_elf_symbol_parallel(tinystl::vector<RuntimeModule> &modules, symbol_query_t *query,
+                                         resolve_pass_t pass) {
+  parallel_resolve_ctx_t ctx;
+  ctx.modules = &modules;
+  ctx.query = query;
+  ctx.pass = pass;
+  ctx.next = 0;
+  ctx.found = false;
+  ctx.result = NULL;
+
+  // the current thread is one of the workers
+  int worker_count = parallel_resolve_worker_count;
+  if ((size_t)worker_count > modules.size())
+    worker_count = modules.size();
+
+  tinystl::vector<pthread_t> workers;
+  for (int i = 1; i < worker_count; i++) {
+    pthread_t worker;
+    if (pthread_create(&worker, NULL, parallel_resolve_worker, &ctx) != 0)
+      break;
+    workers.push_back(worker);
+  }
+  parallel_resolve_worker(&ctx);
+
+  for (auto worker : workers) {
+    pthread_join(worker, NULL);
+  }
+  return ctx.result;
+}
+
 void *resolve_elf_internal_symbol(const char *library_name, const char *symbol_name) {
   void *result = NULL;
 
+  symbol_query_t query;
+  symbol_query_init(&query, symbol_name);
+
   if (library_name) {
     RuntimeModule module = ProcessRuntimeUtility::GetProcessModule(library_name);
+    result = resolve_elf_module_symbol(&module, &query, kResolveSymbolTable, NULL);
+    if (!result)
+      result = resolve_elf_module_symbol(&module, &query, kResolveMiniDebugInfo, NULL);
+    if (result)
+      return result;
+  }
 
-    if (module.load_address) {
-      auto mmapFileMng = MmapFileManager(module.path);
-      auto file_mem = mmapFileMng.map();
+  auto ProcessModuleMap = ProcessRuntimeUtility::GetProcessModuleMap();
+  for (auto pass : {kResolveSymbolTable, kResolveMiniDebugInfo}) {
+    if (parallel_resolve_worker_count > 1) {
+      result = resolve_elf_symbol_parallel(ProcessModuleMap, &query, pass);
+      if (result)
+        return result;
+      continue;
+    }
 
-      elf_ctx_t ctx;
-      memset(&ctx, 0, sizeof(elf_ctx_t));
-      if (file_mem) {
-        elf_ctx_init(&ctx, file_mem);
-        result = elf_ctx_iterate_symbol_table(&ctx, symbol_name);
+    for (auto module : ProcessModuleMap) {
+      result = resolve_elf_module_symbol(&module, &query, pass, NULL);
+      if (result)
+        return result;
+    }
+  }
+  return NULL;
+}
+
+// ================================================================
+// batch resolve
+
+// open addressing set of the requested symbol names, keyed by the gnu hash
+typedef struct symbol_name_set {
+  const char **names;
+  void **out;
+  int count;
+  int pending;
+
+  std::vector<uint32_t> hashes;
+  std::vector<int> slots; // index of names, -1 if empty
+  uint32_t mask;
+} symbol_name_set_t;
+
+static void symbol_name_set_init(symbol_name_set_t *set, const char **names, void **out, int count) {
+  set->names = names;
+  set->out = out;
+  set->count = count;
+  set->pending = 0;
+
+  uint32_t capacity = 16;
+  while (capacity < (uint32_t)count * 2)
+    capacity <<= 1;
+  set->mask = capacity - 1;
+  set->slots.assign(capacity, -1);
+  set->hashes.resize(count);
+
+  for (int i = 0; i < count; i++) {
+    out[i] = NULL;
+    set->hashes[i] = elf_gnu_hash(names[i]);
+
+    // duplicated name share the first slot, fill them at the end
+    uint32_t slot = set->hashes[i] & set->mask;
+    bool duplicated = false;
+    while (set->slots[slot] != -1) {
+      int j = set->slots[slot];
+      if (set->hashes[j] == set->hashes[i] && strcmp(names[j], names[i]) == 0) {
+        duplicated = true;
+        break;
       }
+      slot = (slot + 1) & set->mask;
+    }
+    if (duplicated)
+      continue;
+    set->slots[slot] = i;
+    set->pending++;
+  }
+}
 
-      if (result)
-        result = (void *)((addr_t)result + (addr_t)module.load_address - ((addr_t)file_mem - (addr_t)ctx.load_bias));
+static int symbol_name_set_find(symbol_name_set_t *set, const char *name) {
+  uint32_t hash = elf_gnu_hash(name);
+  uint32_t slot = hash & set->mask;
+  while (set->slots[slot] != -1) {
+    int i = set->slots[slot];
+    if (set->hashes[i] == hash && strcmp(set->names[i], name) == 0)
+      return i;
+    slot = (slot + 1) & set->mask;
+  }
+  return -1;
+}
+
+static void iterate_symbol_table_batch_impl(symbol_name_set_t *set, ElfW(Sym) * symtab, const char *strtab,
+                                            size_t strtab_size, size_t count, addr_t slide) {
+  // the names are hashed up to their terminator, the table must end with one
+  if (strtab_size == 0 || strtab[strtab_size - 1] != 0)
+    return;
+
+  for (size_t i = 0; i < count && set->pending; ++i) {
+    ElfW(Sym) *sym = symtab + i;
+    if (sym->st_name == 0 || sym->st_name >= strtab_size || sym->st_shndx == SHN_UNDEF || sym->st_value == 0)
+      continue;
+
+    int ndx = symbol_name_set_find(set, strtab + sym->st_name);
+    if (ndx == -1 || set->out[ndx])
+      continue;
+
+    set->out[ndx] = (void *)((addr_t)sym->st_value + slide);
+    set->pending--;
+  }
+}
+
+static void resolve_elf_module_symbols_batch(RuntimeModule *module, symbol_name_set_t *set, resolve_pass_t pass) {
+  if (!module->load_address)
+    return;
+
+  auto mmapFileMng = MmapFileManager(module->path);
+  auto file_mem = mmapFileMng.map();
+  if (!file_mem)
+    return;
+
+  elf_ctx_t ctx;
+  memset(&ctx, 0, sizeof(elf_ctx_t));
+  elf_ctx_init(&ctx, file_mem);
+
+  addr_t slide = (addr_t)module->load_address - ((addr_t)file_mem - (addr_t)ctx.load_bias);
+  if (pass == kResolveMiniDebugInfo) {
+    auto mini_debug_info = mini_debug_info_acquire(&ctx, module->path);
+    if (mini_debug_info) {
+      iterate_symbol_table_batch_impl(set, mini_debug_info->symtab, mini_debug_info->strtab,
+                                      mini_debug_info->strtab_size, mini_debug_info->count, slide);
+      mini_debug_info_release(mini_debug_info);
     }
+    return;
   }
 
-  if (!result) {
-    auto ProcessModuleMap = ProcessRuntimeUtility::GetProcessModuleMap();
-    for (auto module : ProcessModuleMap) {
+  if (ctx.symtab_ && ctx.strtab_) {
+    size_t count = ctx.sym_sh_->sh_size / sizeof(ElfW(Sym));
+    iterate_symbol_table_batch_impl(set, ctx.symtab_, ctx.strtab_, ctx.strtab_size_, count, slide);
+  }
+  if (ctx.dynsymtab_ && ctx.dynstrtab_) {
+    size_t count = ctx.dynsym_sh_->sh_size / sizeof(ElfW(Sym));
+    iterate_symbol_table_batch_impl(set, ctx.dynsymtab_, ctx.dynstrtab_, ctx.dynstrtab_size_, count, slide);
+  }
+}
 
-      if (module.load_address) {
-        auto mmapFileMng = MmapFileManager(module.path);
-        auto file_mem = mmapFileMng.map();
+PUBLIC int DobbySymbolResolverBatch(const char *image_name, const char **symbol_names, void **out, int count) {
+  if (count <= 0)
+    return 0;
+
+  symbol_name_set_t set;
+  symbol_name_set_init(&set, symbol_names, out, count);
+
+  // scan the specified image first, each table is scanned only once
+  void *image_load_address = NULL;
+  if (image_name) {
+    RuntimeModule module = ProcessRuntimeUtility::GetProcessModule(image_name);
+    image_load_address = module.load_address;
+    resolve_elf_module_symbols_batch(&module, &set, kResolveSymbolTable);
+    if (set.pending)
+      resolve_elf_module_symbols_batch(&module, &set, kResolveMiniDebugInfo);
+  }
 
-        elf_ctx_t ctx;
-        memset(&ctx, 0, sizeof(elf_ctx_t));
-        if (file_mem) {
-          elf_ctx_init(&ctx, file_mem);
-          result = elf_ctx_iterate_symbol_table(&ctx, symbol_name);
-        }
+  // exported symbol by the linker hash table
+  for (int i = 0; i < count && set.pending; i++) {
+    // skip the duplicated names
+    if (out[i] || symbol_name_set_find(&set, symbol_names[i]) != i)
+      continue;
+    out[i] = dlsym(RTLD_DEFAULT, symbol_names[i]);
+    if (out[i])
+      set.pending--;
+  }
 
-        if (result)
-          result = (void *)((addr_t)result + (addr_t)module.load_address - ((addr_t)file_mem - (addr_t)ctx.load_bias));
+  if (set.pending) {
+    auto ProcessModuleMap = ProcessRuntimeUtility::GetProcessModuleMap();
+    for (auto pass : {kResolveSymbolTable, kResolveMiniDebugInfo}) {
+      for (auto module : ProcessModuleMap) {
+        if (set.pending == 0)
+          break;
+        if (module.load_address == image_load_address)
+          continue;
+        resolve_elf_module_symbols_batch(&module, &set, pass);
       }
+    }
+  }
 
-      if (result)
-        break;
+  // fill duplicated names and report the misses
+  int missed = 0;
+  for (int i = 0; i < count; i++) {
+    if (!out[i]) {
+      int ndx = symbol_name_set_find(&set, symbol_names[i]);
+      out[i] = out[ndx];
+    }
+    if (!out[i]) {
+      ERROR_LOG("resolve symbol %s failed", symbol_names[i]);
+      missed++;
     }
   }
-  return result;
+  return missed;
+}
+
+// ================================================================
+// pattern resolve
+
+typedef struct symbol_name_entry {
+  const char *name;
+  addr_t address;
+} symbol_name_entry_t;
+
+// module indexes kept in memory with their file mapping, the least recently used one is dropped beyond it
+#define SYMBOL_NAME_INDEX_CACHE_MAX 4
+
+// names returned to the caller, the oldest one is dropped beyond it
+#define SYMBOL_NAME_POOL_MAX 4096
+
+// the symbols of a module sorted by name, the file mapping is kept for the names
+typedef struct symbol_name_index {
+  char path[1024];
+  void *load_address;
+  addr_t slide;
+  uint64_t last_use;
+
+  MmapFileManager *file;
+  bool indexed;
+  std::vector<symbol_name_entry_t> entries;
+
+  // MiniDebugInfo symbols, only indexed once a pattern misses the symbol tables of all modules
+  bool debug_indexed;
+  mini_debug_info_t *mini_debug_info;
+  std::vector<symbol_name_entry_t> debug_entries;
+} symbol_name_index_t;
+
+// the indexes and the matched names, held while building and matching an index
+static std::vector<symbol_name_index_t *> symbol_name_index_cache;
+static uint64_t symbol_name_index_clock = 0;
+static pthread_mutex_t symbol_name_index_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// names returned to the caller, copied out of the index as it may be dropped
+static std::unordered_set<std::string> symbol_name_pool;
+static std::deque<const std::string *> symbol_name_pool_order;
+
+static const char *symbol_name_pool_insert_locked(const char *name) {
+  auto result = symbol_name_pool.insert(name);
+  if (result.second) {
+    symbol_name_pool_order.push_back(&*result.first);
+    if (symbol_name_pool_order.size() > SYMBOL_NAME_POOL_MAX) {
+      symbol_name_pool.erase(symbol_name_pool.find(*symbol_name_pool_order.front()));
+      symbol_name_pool_order.pop_front();
+    }
+  }
+  return result.first->c_str();
+}
+
+static void symbol_name_index_append(std::vector<symbol_name_entry_t> &entries, ElfW(Sym) * symtab,
+                                     const char *strtab, size_t strtab_size, size_t count, addr_t slide) {
+  if (strtab_size == 0 || strtab[strtab_size - 1] != 0)
+    return;
+
+  for (size_t i = 0; i < count; ++i) {
+    ElfW(Sym) *sym = symtab + i;
+    if (sym->st_name == 0 || sym->st_name >= strtab_size || sym->st_shndx == SHN_UNDEF || sym->st_value == 0)
+      continue;
+    entries.push_back({strtab + sym->st_name, (addr_t)sym->st_value + slide});
+  }
+}
+
+// keep the first one of the same name, .symtab has precedence
+static void symbol_name_index_sort(std::vector<symbol_name_entry_t> &entries) {
+  std::stable_sort(entries.begin(), entries.end(), [](const symbol_name_entry_t &a, const symbol_name_entry_t &b) {
+    return strcmp(a.name, b.name) < 0;
+  });
+  auto last = std::unique(entries.begin(), entries.end(), [](const symbol_name_entry_t &a, const symbol_name_entry_t &b) {
+    return strcmp(a.name, b.name) == 0;
+  });
+  entries.erase(last, entries.end());
+  entries.shrink_to_fit();
+}
+
+static void symbol_name_index_destroy(symbol_name_index_t *index) {
+  if (index->mini_debug_info)
+    mini_debug_info_release(index->mini_debug_info);
+  delete index->file;
+  delete index;
+}
+
+static void symbol_name_index_trim_locked() {
+  while (symbol_name_index_cache.size() > SYMBOL_NAME_INDEX_CACHE_MAX) {
+    auto victim = symbol_name_index_cache.begin();
+    for (auto iter = symbol_name_index_cache.begin(); iter != symbol_name_index_cache.end(); iter++) {
+      if ((*iter)->last_use < (*victim)->last_use)
+        victim = iter;
+    }
+    symbol_name_index_destroy(*victim);
+    symbol_name_index_cache.erase(victim);
+  }
+}
+
+// the cached index of the module, its tables are indexed by the pass using them
+static symbol_name_index_t *symbol_name_index_get_locked(RuntimeModule *module) {
+  for (auto index : symbol_name_index_cache) {
+    if (index->load_address == module->load_address && strcmp(index->path, module->path) == 0) {
+      index->last_use = ++symbol_name_index_clock;
+      return index;
+    }
+  }
+
+  auto index = new symbol_name_index_t();
+  size_t path_len = strnlen(module->path, sizeof(index->path) - 1);
+  memcpy(index->path, module->path, path_len);
+  index->path[path_len] = 0;
+  index->load_address = module->load_address;
+  index->slide = 0;
+  index->last_use = ++symbol_name_index_clock;
+  index->file = new MmapFileManager(index->path);
+  index->indexed = false;
+  index->debug_indexed = false;
+  index->mini_debug_info = NULL;
+  symbol_name_index_cache.push_back(index);
+  symbol_name_index_trim_locked();
+  return index;
+}
+
+static std::vector<symbol_name_entry_t> &symbol_name_index_load_locked(symbol_name_index_t *index,
+                                                                       resolve_pass_t pass) {
+  auto &entries = pass == kResolveSymbolTable ? index->entries : index->debug_entries;
+  bool &indexed = pass == kResolveSymbolTable ? index->indexed : index->debug_indexed;
+  if (indexed)
+    return entries;
+  indexed = true;
+
+  auto file_mem = index->file->map();
+  if (!file_mem)
+    return entries;
+
+  elf_ctx_t ctx;
+  memset(&ctx, 0, sizeof(elf_ctx_t));
+  elf_ctx_init(&ctx, file_mem);
+  index->slide = (addr_t)index->load_address - ((addr_t)file_mem - (addr_t)ctx.load_bias);
+
+  if (pass == kResolveSymbolTable) {
+    if (ctx.symtab_ && ctx.strtab_) {
+      size_t count = ctx.sym_sh_->sh_size / sizeof(ElfW(Sym));
+      symbol_name_index_append(entries, ctx.symtab_, ctx.strtab_, ctx.strtab_size_, count, index->slide);
+    }
+    if (ctx.dynsymtab_ && ctx.dynstrtab_) {
+      size_t count = ctx.dynsym_sh_->sh_size / sizeof(ElfW(Sym));
+      symbol_name_index_append(entries, ctx.dynsymtab_, ctx.dynstrtab_, ctx.dynstrtab_size_, count, index->slide);
+    }
+  } else {
+    // the names point into the symbol table, the index keeps it referenced
+    index->mini_debug_info = mini_debug_info_acquire(&ctx, index->path);
+    if (!index->mini_debug_info)
+      return entries;
+    auto mini_debug_info = index->mini_debug_info;
+    symbol_name_index_append(entries, mini_debug_info->symtab, mini_debug_info->strtab, mini_debug_info->strtab_size,
+                             mini_debug_info->count, index->slide);
+  }
+  symbol_name_index_sort(entries);
+
+  DEBUG_LOG("build symbol name index of %s, %d symbols", index->path, (int)entries.size());
+  return entries;
+}
+
+// glob match, support '*' and '?'
+static bool symbol_name_glob_match(const char *pattern, const char *name) {
+  const char *star = NULL;
+  const char *backtrack = NULL;
+  while (*name) {
+    if (*pattern == '*') {
+      star = pattern++;
+      backtrack = name;
+    } else if (*pattern == '?' || *pattern == *name) {
+      pattern++;
+      name++;
+    } else if (star) {
+      pattern = star + 1;
+      name = ++backtrack;
+    } else {
+      return false;
+    }
+  }
+  while (*pattern == '*')
+    pattern++;
+  return *pattern == 0;
+}
+
+static int symbol_name_index_match_locked(std::vector<symbol_name_entry_t> &entries, const char *pattern,
+                                          DobbySymbolMatch *matches, int max_count, int matched) {
+  // the literal prefix before the first wildcard selects the range
+  size_t prefix_len = strcspn(pattern, "*?");
+  bool is_exact = pattern[prefix_len] == 0;
+
+  auto begin = std::lower_bound(entries.begin(), entries.end(), pattern,
+                                [prefix_len](const symbol_name_entry_t &entry, const char *prefix) {
+                                  return strncmp(entry.name, prefix, prefix_len) < 0;
+                                });
+  for (auto iter = begin; iter != entries.end() && matched < max_count; iter++) {
+    if (strncmp(iter->name, pattern, prefix_len) != 0)
+      break;
+    if (is_exact ? iter->name[prefix_len] != 0 : !symbol_name_glob_match(pattern + prefix_len, iter->name + prefix_len))
+      continue;
+
+    matches[matched].name = symbol_name_pool_insert_locked(iter->name);
+    matches[matched].address = (void *)iter->address;
+    matched++;
+  }
+  return matched;
+}
+
+PUBLIC int DobbySymbolResolverMatch(const char *image_name, const char *pattern, DobbySymbolMatch *matches,
+                                    int max_count) {
+  int matched = 0;
+
+  // the symbol tables of all modules are matched before any MiniDebugInfo is decompressed
+  auto ProcessModuleMap = ProcessRuntimeUtility::GetProcessModuleMap();
+  for (auto pass : {kResolveSymbolTable, kResolveMiniDebugInfo}) {
+    for (auto module : ProcessModuleMap) {
+      if (matched >= max_count)
+        return matched;
+      if (!module.load_address)
+        continue;
+      if (image_name && strstr(module.path, image_name) == NULL)
+        continue;
+
+      pthread_mutex_lock(&symbol_name_index_cache_lock);
+      auto index = symbol_name_index_get_locked(&module);
+      auto &entries = symbol_name_index_load_locked(index, pass);
+      matched = symbol_name_index_match_locked(entries, pattern, matches, max_count, matched);
+      pthread_mutex_unlock(&symbol_name_index_cache_lock);
+    }
+    if (matched)
+      break;
+  }
+  return matched;
 }
 
 // impl at "android_restriction.cc"
@@ -229,6 +1003,14 @@ PUBLIC void *DobbySymbolResolver(const char *image_name, const char *symbol_name
     }
   }
 #endif
+  // wildcard pattern, return the first match
+  if (strpbrk(symbol_name_pattern, "*?")) {
+    DobbySymbolMatch match;
+    if (DobbySymbolResolverMatch(image_name, symbol_name_pattern, &match, 1))
+      return match.address;
+    return NULL;
+  }
+
   result = dlsym(RTLD_DEFAULT, symbol_name_pattern);
   if (result)
     return result;
@@ -0,0 +1,461 @@
+#include "xz_decoder.h"
+
+#include <string.h>
+
+// refer: https://tukaani.org/xz/xz-file-format.txt
+// refer: xz-embedded, linux/lib/xz/xz_dec_lzma2.c
+
+#define XZ_HEADER_SIZE 12
+#define XZ_FOOTER_SIZE 12
+#define XZ_FILTER_LZMA2 0x21
+
+#define LZMA_STATES 12
+#define LZMA_LIT_STATES 7
+#define LZMA_POS_STATES_MAX (1 << 4)
+#define LZMA_DIST_STATES 4
+#define LZMA_DIST_SLOTS 64
+#define LZMA_DIST_MODEL_START 4
+#define LZMA_DIST_MODEL_END 14
+#define LZMA_FULL_DISTANCES (1 << (LZMA_DIST_MODEL_END / 2))
+#define LZMA_ALIGN_BITS 4
+#define LZMA_MATCH_LEN_MIN 2
+#define LZMA_LITERAL_CODER_SIZE 0x300
+#define LZMA_LITERAL_CODERS_MAX (1 << 4)
+
+#define RC_BIT_MODEL_TOTAL_BITS 11
+#define RC_BIT_MODEL_TOTAL (1 << RC_BIT_MODEL_TOTAL_BITS)
+#define RC_MOVE_BITS 5
+#define RC_TOP_VALUE (1 << 24)
+
+typedef uint16_t prob_t;
+
+typedef struct lzma_len_dec {
+  prob_t choice;
+  prob_t choice2;
+  prob_t low[LZMA_POS_STATES_MAX][1 << 3];
+  prob_t mid[LZMA_POS_STATES_MAX][1 << 3];
+  prob_t high[1 << 8];
+} lzma_len_dec_t;
+
+typedef struct lzma_dec {
+  uint32_t lc, lp, pb;
+
+  uint32_t state;
+  uint32_t rep0, rep1, rep2, rep3;
+
+  // match length not copied yet at the end of the previous chunk
+  uint32_t pending_len;
+
+  prob_t is_match[LZMA_STATES][LZMA_POS_STATES_MAX];
+  prob_t is_rep[LZMA_STATES];
+  prob_t is_rep0[LZMA_STATES];
+  prob_t is_rep1[LZMA_STATES];
+  prob_t is_rep2[LZMA_STATES];
+  prob_t is_rep0_long[LZMA_STATES][LZMA_POS_STATES_MAX];
+  prob_t dist_slot[LZMA_DIST_STATES][LZMA_DIST_SLOTS];
+  prob_t dist_special[LZMA_FULL_DISTANCES - LZMA_DIST_MODEL_END];
+  prob_t dist_align[1 << LZMA_ALIGN_BITS];
+  lzma_len_dec_t match_len_dec;
+  lzma_len_dec_t rep_len_dec;
+  prob_t literal[LZMA_LITERAL_CODERS_MAX][LZMA_LITERAL_CODER_SIZE];
+} lzma_dec_t;
+
+typedef struct rc_dec {
+  const uint8_t *in;
+  const uint8_t *in_end;
+  uint32_t range;
+  uint32_t code;
+  bool overrun;
+} rc_dec_t;
+
+// ---
+
+static inline uint8_t rc_next_byte(rc_dec_t *rc) {
+  if (rc->in == rc->in_end) {
+    rc->overrun = true;
+    return 0;
+  }
+  return *rc->in++;
+}
+
+static bool rc_init(rc_dec_t *rc, const uint8_t *in, size_t in_size) {
+  rc->in = in;
+  rc->in_end = in + in_size;
+  rc->range = 0xFFFFFFFF;
+  rc->code = 0;
+  rc->overrun = false;
+
+  // the first byte is always 0
+  if (in_size < 5 || rc_next_byte(rc) != 0)
+    return false;
+  for (int i = 0; i < 4; i++)
+    rc->code = (rc->code << 8) | rc_next_byte(rc);
+  return true;
+}
+
+static inline void rc_normalize(rc_dec_t *rc) {
+  if (rc->range < RC_TOP_VALUE) {
+    rc->range <<= 8;
+    rc->code = (rc->code << 8) | rc_next_byte(rc);
+  }
+}
+
+static inline uint32_t rc_bit(rc_dec_t *rc, prob_t *prob) {
+  rc_normalize(rc);
+  uint32_t bound = (rc->range >> RC_BIT_MODEL_TOTAL_BITS) * *prob;
+  if (rc->code < bound) {
+    rc->range = bound;
+    *prob += (RC_BIT_MODEL_TOTAL - *prob) >> RC_MOVE_BITS;
+    return 0;
+  }
+  rc->range -= bound;
+  rc->code -= bound;
+  *prob -= *prob >> RC_MOVE_BITS;
+  return 1;
+}
+
+static inline uint32_t rc_bittree(rc_dec_t *rc, prob_t *probs, uint32_t bits) {
+  uint32_t symbol = 1;
+  for (uint32_t i = 0; i < bits; i++)
+    symbol = (symbol << 1) | rc_bit(rc, &probs[symbol]);
+  return symbol - (1 << bits);
+}
+
+static inline uint32_t rc_bittree_reverse(rc_dec_t *rc, prob_t *probs, uint32_t bits) {
+  uint32_t symbol = 1;
+  uint32_t result = 0;
+  for (uint32_t i = 0; i < bits; i++) {
+    uint32_t bit = rc_bit(rc, &probs[symbol]);
+    symbol = (symbol << 1) | bit;
+    result |= bit << i;
+  }
+  return result;
+}
+
+static inline uint32_t rc_direct(rc_dec_t *rc, uint32_t bits) {
+  uint32_t result = 0;
+  for (uint32_t i = 0; i < bits; i++) {
+    rc_normalize(rc);
+    rc->range >>= 1;
+    rc->code -= rc->range;
+    uint32_t mask = 0 - (rc->code >> 31);
+    rc->code += rc->range & mask;
+    result = (result << 1) + (mask + 1);
+  }
+  return result;
+}
+
+// ---
+
+static void lzma_reset(lzma_dec_t *lzma) {
+  lzma->state = 0;
+  lzma->rep0 = lzma->rep1 = lzma->rep2 = lzma->rep3 = 0;
+  lzma->pending_len = 0;
+
+  // all the probabilities are laid out contiguously after `is_match`
+  prob_t *probs = &lzma->is_match[0][0];
+  size_t count = ((uint8_t *)(lzma + 1) - (uint8_t *)probs) / sizeof(prob_t);
+  for (size_t i = 0; i < count; i++)
+    probs[i] = RC_BIT_MODEL_TOTAL / 2;
+}
+
+static bool lzma_props(lzma_dec_t *lzma, uint8_t props) {
+  if (props > (4 * 5 + 4) * 9 + 8)
+    return false;
+  lzma->pb = props / (9 * 5);
+  props -= lzma->pb * 9 * 5;
+  lzma->lp = props / 9;
+  lzma->lc = props - lzma->lp * 9;
+  return lzma->lc + lzma->lp <= 4;
+}
+
+static uint32_t lzma_len(rc_dec_t *rc, lzma_len_dec_t *len_dec, uint32_t pos_state) {
+  if (!rc_bit(rc, &len_dec->choice))
+    return LZMA_MATCH_LEN_MIN + rc_bittree(rc, len_dec->low[pos_state], 3);
+  if (!rc_bit(rc, &len_dec->choice2))
+    return LZMA_MATCH_LEN_MIN + 8 + rc_bittree(rc, len_dec->mid[pos_state], 3);
+  return LZMA_MATCH_LEN_MIN + 16 + rc_bittree(rc, len_dec->high, 8);
+}
+
+static uint32_t lzma_distance(rc_dec_t *rc, lzma_dec_t *lzma, uint32_t len) {
+  uint32_t dist_state = len - LZMA_MATCH_LEN_MIN;
+  if (dist_state > LZMA_DIST_STATES - 1)
+    dist_state = LZMA_DIST_STATES - 1;
+
+  uint32_t dist_slot = rc_bittree(rc, lzma->dist_slot[dist_state], 6);
+  if (dist_slot < LZMA_DIST_MODEL_START)
+    return dist_slot;
+
+  uint32_t bits = (dist_slot >> 1) - 1;
+  uint32_t dist = (2 | (dist_slot & 1)) << bits;
+  if (dist_slot < LZMA_DIST_MODEL_END) {
+    // bittree symbol starts from 1, so the base may point one before dist_special
+    prob_t *probs = lzma->dist_special + (dist - dist_slot) - 1;
+    return dist + rc_bittree_reverse(rc, probs, bits);
+  }
+
+  dist += rc_direct(rc, bits - LZMA_ALIGN_BITS) << LZMA_ALIGN_BITS;
+  return dist + rc_bittree_reverse(rc, lzma->dist_align, LZMA_ALIGN_BITS);
+}
+
+// decode one lzma chunk into out[pos, end), dict_start is the last dictionary reset position
+static bool lzma_decode_chunk(lzma_dec_t *lzma, rc_dec_t *rc, uint8_t *out, size_t dict_start, size_t pos,
+                              size_t end) {
+  uint32_t pos_mask = (1 << lzma->pb) - 1;
+  uint32_t lit_pos_mask = (1 << lzma->lp) - 1;
+
+  auto copy_match = [&](uint32_t dist, uint32_t len) -> bool {
+    if (dist >= pos - dict_start)
+      return false;
+    size_t copy_len = len;
+    if (copy_len > end - pos)
+      copy_len = end - pos;
+    lzma->pending_len = len - copy_len;
+    for (size_t i = 0; i < copy_len; i++, pos++)
+      out[pos] = out[pos - dist - 1];
+    return true;
+  };
+
+  if (lzma->pending_len) {
+    if (!copy_match(lzma->rep0, lzma->pending_len))
+      return false;
+  }
+
+  while (pos < end) {
+    // position is relative to the dictionary reset
+    uint32_t pos_state = (pos - dict_start) & pos_mask;
+
+    if (!rc_bit(rc, &lzma->is_match[lzma->state][pos_state])) {
+      uint8_t prev_byte = pos > dict_start ? out[pos - 1] : 0;
+      uint32_t lit_state = (((pos - dict_start) & lit_pos_mask) << lzma->lc) + (prev_byte >> (8 - lzma->lc));
+      prob_t *probs = lzma->literal[lit_state];
+
+      uint32_t symbol = 1;
+      if (lzma->state < LZMA_LIT_STATES) {
+        while (symbol < 0x100)
+          symbol = (symbol << 1) | rc_bit(rc, &probs[symbol]);
+      } else {
+        if (lzma->rep0 >= pos - dict_start)
+          return false;
+        uint32_t match_byte = out[pos - lzma->rep0 - 1];
+        uint32_t offset = 0x100;
+        while (symbol < 0x100) {
+          match_byte <<= 1;
+          uint32_t match_bit = match_byte & offset;
+          if (rc_bit(rc, &probs[offset + match_bit + symbol])) {
+            symbol = (symbol << 1) | 1;
+            offset &= match_bit;
+          } else {
+            symbol <<= 1;
+            offset &= ~match_bit;
+          }
+        }
+      }
+      out[pos++] = (uint8_t)symbol;
+
+      if (lzma->state < 4)
+        lzma->state = 0;
+      else if (lzma->state < 10)
+        lzma->state -= 3;
+      else
+        lzma->state -= 6;
+    } else if (rc_bit(rc, &lzma->is_rep[lzma->state])) {
+      if (!rc_bit(rc, &lzma->is_rep0[lzma->state])) {
+        if (!rc_bit(rc, &lzma->is_rep0_long[lzma->state][pos_state])) {
+          // short rep
+          lzma->state = lzma->state < LZMA_LIT_STATES ? 9 : 11;
+          if (!copy_match(lzma->rep0, 1))
+            return false;
+          continue;
+        }
+      } else {
+        uint32_t dist;
+        if (!rc_bit(rc, &lzma->is_rep1[lzma->state])) {
+          dist = lzma->rep1;
+        } else {
+          if (!rc_bit(rc, &lzma->is_rep2[lzma->state])) {
+            dist = lzma->rep2;
+          } else {
+            dist = lzma->rep3;
+            lzma->rep3 = lzma->rep2;
+          }
+          lzma->rep2 = lzma->rep1;
+        }
+        lzma->rep1 = lzma->rep0;
+        lzma->rep0 = dist;
+      }
+
+      lzma->state = lzma->state < LZMA_LIT_STATES ? 8 : 11;
+      uint32_t len = lzma_len(rc, &lzma->rep_len_dec, pos_state);
+      if (!copy_match(lzma->rep0, len))
+        return false;
+    } else {
+      lzma->rep3 = lzma->rep2;
+      lzma->rep2 = lzma->rep1;
+      lzma->rep1 = lzma->rep0;
+
+      uint32_t len = lzma_len(rc, &lzma->match_len_dec, pos_state);
+      lzma->state = lzma->state < LZMA_LIT_STATES ? 7 : 10;
+      lzma->rep0 = lzma_distance(rc, lzma, len);
+      if (!copy_match(lzma->rep0, len))
+        return false;
+    }
+
+    if (rc->overrun)
+      return false;
+  }
+
+  return !rc->overrun;
+}
+
+// decode the lzma2 chunks of one block, return the consumed size, 0 if failed
+static size_t lzma2_decode(lzma_dec_t *lzma, const uint8_t *in, size_t in_size, std::vector<uint8_t> &out) {
+  const uint8_t *cursor = in;
+  const uint8_t *in_end = in + in_size;
+
+  size_t dict_start = out.size();
+  bool need_dict_reset = true;
+  bool need_props = true;
+
+  while (cursor < in_end) {
+    uint8_t control = *cursor++;
+    if (control == 0x00)
+      return cursor - in;
+
+    if (control >= 0xE0 || control == 0x01) {
+      need_props = true;
+      need_dict_reset = false;
+      dict_start = out.size();
+    } else if (need_dict_reset) {
+      return 0;
+    }
+
+    if (control < 0x80) {
+      // uncompressed chunk
+      if (control > 0x02 || in_end - cursor < 2)
+        return 0;
+      size_t size = ((cursor[0] << 8) | cursor[1]) + 1;
+      cursor += 2;
+      if ((size_t)(in_end - cursor) < size)
+        return 0;
+      out.insert(out.end(), cursor, cursor + size);
+      cursor += size;
+      continue;
+    }
+
+    // lzma chunk
+    if (in_end - cursor < 4)
+      return 0;
+    size_t unpacked_size = (((size_t)control & 0x1F) << 16) + (cursor[0] << 8) + cursor[1] + 1;
+    size_t packed_size = (cursor[2] << 8) + cursor[3] + 1;
+    cursor += 4;
+
+    if (control >= 0xC0) {
+      if (cursor == in_end || !lzma_props(lzma, *cursor++))
+        return 0;
+      need_props = false;
+      lzma_reset(lzma);
+    } else if (need_props) {
+      return 0;
+    } else if (control >= 0xA0) {
+      lzma_reset(lzma);
+    }
+
+    if ((size_t)(in_end - cursor) < packed_size)
+      return 0;
+
+    rc_dec_t rc;
+    if (!rc_init(&rc, cursor, packed_size))
+      return 0;
+
+    size_t pos = out.size();
+    out.resize(pos + unpacked_size);
+    if (!lzma_decode_chunk(lzma, &rc, out.data(), dict_start, pos, pos + unpacked_size))
+      return 0;
+    cursor += packed_size;
+  }
+  return 0;
+}
+
+// ---
+
+static bool read_multibyte_integer(const uint8_t **cursor, const uint8_t *end, uint64_t *value) {
+  *value = 0;
+  for (int i = 0; i < 9; i++) {
+    if (*cursor == end)
+      return false;
+    uint8_t byte = *(*cursor)++;
+    *value |= (uint64_t)(byte & 0x7F) << (i * 7);
+    if ((byte & 0x80) == 0)
+      return true;
+  }
+  return false;
+}
+
+bool xz_decompress(const uint8_t *in, size_t in_size, std::vector<uint8_t> &out) {
+  static const uint8_t xz_magic[6] = {0xFD, '7', 'z', 'X', 'Z', 0x00};
+  if (in_size < XZ_HEADER_SIZE + XZ_FOOTER_SIZE || memcmp(in, xz_magic, sizeof(xz_magic)) != 0)
+    return false;
+
+  // stream flags, repeated in the footer which also tells a truncated stream
+  const uint8_t *footer = in + in_size - XZ_FOOTER_SIZE;
+  if (in[6] != 0x00 || in[7] > 0x0F || memcmp(footer + 8, in + 6, 2) != 0 || footer[10] != 'Y' || footer[11] != 'Z')
+    return false;
+  uint8_t check_type = in[7];
+  size_t check_size = check_type == 0 ? 0 : 4 << ((check_type - 1) / 3);
+
+  const uint8_t *cursor = in + XZ_HEADER_SIZE;
+  const uint8_t *in_end = footer;
+
+  lzma_dec_t *lzma = new lzma_dec_t;
+  bool result = false;
+  out.clear();
+
+  while (cursor < in_end) {
+    const uint8_t *block = cursor;
+
+    // the index, after all the blocks
+    if (*block == 0x00) {
+      result = true;
+      break;
+    }
+
+    // block header
+    size_t header_size = ((size_t)block[0] + 1) * 4;
+    if ((size_t)(in_end - block) < header_size)
+      break;
+    const uint8_t *header_end = block + header_size - 4;
+    uint8_t block_flags = block[1];
+    cursor = block + 2;
+
+    uint64_t value;
+    if (block_flags & 0x40) {
+      if (!read_multibyte_integer(&cursor, header_end, &value))
+        break;
+    }
+    if (block_flags & 0x80) {
+      if (!read_multibyte_integer(&cursor, header_end, &value))
+        break;
+    }
+
+    // only one lzma2 filter, the dictionary size in properties is useless as the whole output is the dictionary
+    uint64_t filter_id, props_size;
+    if ((block_flags & 0x03) != 0 || !read_multibyte_integer(&cursor, header_end, &filter_id) ||
+        filter_id != XZ_FILTER_LZMA2 || !read_multibyte_integer(&cursor, header_end, &props_size) || props_size != 1)
+      break;
+
+    cursor = block + header_size;
+    size_t consumed = lzma2_decode(lzma, cursor, in_end - cursor, out);
+    if (consumed == 0)
+      break;
+    cursor += consumed;
+
+    // block padding and check
+    while ((cursor - block) % 4)
+      cursor++;
+    cursor += check_size;
+  }
+
+  delete lzma;
+  return result;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <vector>
+
+// minimal .xz decoder for the MiniDebugInfo (.gnu_debugdata) section
+// only the lzma2 filter is supported, integrity checks are skipped
+bool xz_decompress(const uint8_t *in, size_t in_size, std::vector<uint8_t> &out);
@@ -5,6 +5,8 @@
 #include <assert.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
 #include <time.h>
 
 #if defined(__linux__) || defined(__APPLE__)
@@ -12,6 +14,7 @@
 #include <syslog.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <sys/types.h>
 #endif
 
@@ -39,24 +42,42 @@
 
 Logger *Logger::g_logger = nullptr;
 
+static bool log_async_record(Logger *logger, const char *fmt, va_list ap);
+
+int Logger::formatPrefix(char *buffer, size_t buffer_size, time_t now) {
+  int len = 0;
+  if (log_tag_ != nullptr) {
+    len += snprintf(buffer + len, buffer_size - len, "%s ", log_tag_);
+  }
+
+  if (enable_time_tag_ && len < (int)buffer_size) {
+    struct tm tm;
+#if defined(_WIN32)
+    localtime_s(&tm, &now);
+#else
+    localtime_r(&now, &tm);
+#endif
+    len += snprintf(buffer + len, buffer_size - len, "%04d-%02d-%02d %02d:%02d:%02d ", tm.tm_year + 1900, tm.tm_mon + 1,
+                    tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec);
+  }
+  return len < (int)buffer_size ? len : (int)buffer_size - 1;
+}
+
 void Logger::logv(LogLevel level, const char *_fmt, va_list ap) {
   if (level < log_level_)
     return;
 
-  char fmt_buffer[4096] = {0};
-
-  if (log_tag_ != nullptr) {
-    snprintf(fmt_buffer + strlen(fmt_buffer), sizeof(fmt_buffer) - strlen(fmt_buffer), "%s ", log_tag_);
+  if (enable_async_) {
+    if (level < LOG_LEVEL_FATAL && log_async_record(this, _fmt, ap))
+      return;
+    // keep the queued messages ahead of a synchronous one
+    flush();
   }
 
-  if (enable_time_tag_) {
-    time_t now = time(NULL);
-    struct tm *tm = localtime(&now);
-    snprintf(fmt_buffer + strlen(fmt_buffer), sizeof(fmt_buffer) - strlen(fmt_buffer), "%04d-%02d-%02d %02d:%02d:%02d ",
-             tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday, tm->tm_hour, tm->tm_min, tm->tm_sec);
-  }
+  char fmt_buffer[4096] = {0};
 
-  snprintf(fmt_buffer + strlen(fmt_buffer), sizeof(fmt_buffer) - strlen(fmt_buffer), "%s\n", _fmt);
+  int len = formatPrefix(fmt_buffer, sizeof(fmt_buffer), enable_time_tag_ ? time(NULL) : 0);
+  snprintf(fmt_buffer + len, sizeof(fmt_buffer) - len, "%s\n", _fmt);
 
   if (enable_syslog_) {
 #if defined(__APPLE__)
@@ -111,6 +132,545 @@ void Logger::logv(LogLevel level, const char *_fmt, va_list ap) {
   }
 }
 
+void Logger::writeMessage(const char *message) {
+  if (enable_syslog_) {
+#if defined(__APPLE__)
+    syslog(LOG_ALERT, "%s", message);
+#elif defined(_POSIX_VERSION)
+    syslog(LOG_ERR, "%s", message);
+#endif
+  }
+
+  if (log_file_ != nullptr) {
+#if defined(USER_CXX_FILESTREAM)
+    log_file_stream_->write(message, strlen(message));
+    log_file_stream_->flush();
+#else
+    fwrite(message, strlen(message), 1, log_file_stream_);
+    fflush(log_file_stream_);
+#endif
+  }
+
+#if defined(__ANDROID__)
+  __android_log_write(ANDROID_LOG_INFO, NULL, message);
+#else
+  fwrite(message, strlen(message), 1, stdout);
+#endif
+}
+
+#if defined(_POSIX_VERSION)
+
+// queued messages, a power of two
+#define LOG_ASYNC_QUEUE_SIZE 256
+// arguments of a queued message, '*' width and precision take one each
+#define LOG_ASYNC_MAX_ARGS 8
+// copies of the %s arguments of a queued message, longer strings are cut and end with the mark, strings past a full
+// pool are only the mark
+#define LOG_ASYNC_STRING_POOL 192
+#define LOG_ASYNC_STRING_CUT "..."
+
+typedef enum {
+  kLogArgNone,
+  kLogArgInt,
+  kLogArgLong,
+  kLogArgLongLong,
+  kLogArgIntmax,
+  kLogArgSize,
+  kLogArgPtrdiff,
+  kLogArgDouble,
+  kLogArgPointer,
+  kLogArgString,
+  kLogArgUnsupported,
+} LogArgKind;
+
+typedef struct {
+  // past the conversion character
+  const char *end;
+  LogArgKind kind;
+  // '*' width and precision, each consumes an int argument ahead of the value
+  int stars;
+  bool precision_star;
+  // digits precision, -1 if none
+  int precision;
+} LogConversion;
+
+typedef struct {
+  Logger *logger;
+  const char *fmt;
+  time_t time;
+  uint64_t args[LOG_ASYNC_MAX_ARGS];
+  char strings[LOG_ASYNC_STRING_POOL];
+} LogRecord;
+
+// bounded multi-producer multi-consumer queue, a cell is free for the producer at position pos when its sequence is
+// pos, and full for the consumer at pos when it is pos + 1
+typedef struct {
+  size_t sequence;
+  LogRecord record;
+} LogCell;
+
+static LogCell log_queue_[LOG_ASYNC_QUEUE_SIZE];
+static size_t log_enqueue_pos_;
+static size_t log_dequeue_pos_;
+static size_t log_dropped_;
+// the messages ahead of this position are written, only the logging thread writes them once it runs
+static size_t log_written_pos_;
+
+static bool log_consumer_started_;
+static bool log_consumer_waiting_;
+static pthread_mutex_t log_consumer_mutex_ = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t log_consumer_cond_ = PTHREAD_COND_INITIALIZER;
+
+// threads in flush, woken on the flush cond as messages are written
+static int log_flush_waiters_;
+static pthread_cond_t log_flush_cond_ = PTHREAD_COND_INITIALIZER;
+
+// parse the conversion at p, past its '%'
+static LogConversion log_parse_conversion(const char *p) {
+  LogConversion conv = {nullptr, kLogArgUnsupported, 0, false, -1};
+
+  while (*p && strchr("-+ #0'", *p))
+    p++;
+
+  if (*p == '*') {
+    conv.stars++;
+    p++;
+  } else {
+    while (*p >= '0' && *p <= '9')
+      p++;
+  }
+
+  if (*p == '.') {
+    p++;
+    if (*p == '*') {
+      conv.stars++;
+      conv.precision_star = true;
+      p++;
+    } else {
+      conv.precision = 0;
+      while (*p >= '0' && *p <= '9')
+        conv.precision = conv.precision * 10 + (*p++ - '0');
+    }
+  }
+
+  LogArgKind int_kind = kLogArgInt;
+  bool wide = false;
+  if (p[0] == 'h') {
+    p += p[1] == 'h' ? 2 : 1;
+  } else if (p[0] == 'l' && p[1] == 'l') {
+    int_kind = kLogArgLongLong;
+    p += 2;
+  } else if (p[0] == 'l') {
+    int_kind = kLogArgLong;
+    wide = true;
+    p++;
+  } else if (p[0] == 'q') {
+    int_kind = kLogArgLongLong;
+    p++;
+  } else if (p[0] == 'j') {
+    int_kind = kLogArgIntmax;
+    p++;
+  } else if (p[0] == 'z') {
+    int_kind = kLogArgSize;
+    p++;
+  } else if (p[0] == 't') {
+    int_kind = kLogArgPtrdiff;
+    p++;
+  } else if (p[0] == 'L') {
+    // long double
+    return conv;
+  }
+
+  switch (*p) {
+  case 'd':
+  case 'i':
+  case 'o':
+  case 'u':
+  case 'x':
+  case 'X':
+    conv.kind = int_kind;
+    break;
+  case 'c':
+    conv.kind = wide ? kLogArgUnsupported : kLogArgInt;
+    break;
+  case 'f':
+  case 'F':
+  case 'e':
+  case 'E':
+  case 'g':
+  case 'G':
+  case 'a':
+  case 'A':
+    conv.kind = kLogArgDouble;
+    break;
+  case 'p':
+    conv.kind = kLogArgPointer;
+    break;
+  case 's':
+    conv.kind = wide ? kLogArgUnsupported : kLogArgString;
+    break;
+  case '%':
+    conv.kind = kLogArgNone;
+    break;
+  default:
+    // %n, %m and anything unknown
+    return conv;
+  }
+  conv.end = p + 1;
+  return conv;
+}
+
+// copy the arguments of fmt into record, false if fmt needs the synchronous path
+static bool log_capture_args(LogRecord *record, const char *fmt, va_list ap) {
+  int nargs = 0;
+  size_t strings_len = 0;
+  // the mark ends the pool
+  const size_t strings_size = LOG_ASYNC_STRING_POOL - sizeof(LOG_ASYNC_STRING_CUT);
+  memcpy(record->strings + strings_size, LOG_ASYNC_STRING_CUT, sizeof(LOG_ASYNC_STRING_CUT));
+  for (const char *p = fmt; *p; p++) {
+    if (*p != '%')
+      continue;
+    LogConversion conv = log_parse_conversion(p + 1);
+    if (conv.kind == kLogArgUnsupported || nargs + conv.stars + (conv.kind != kLogArgNone) > LOG_ASYNC_MAX_ARGS)
+      return false;
+    p = conv.end - 1;
+
+    for (int i = 0; i < conv.stars; i++)
+      record->args[nargs++] = (uint64_t)(int64_t)va_arg(ap, int);
+    if (conv.precision_star)
+      conv.precision = (int)(int64_t)record->args[nargs - 1];
+
+    uint64_t arg = 0;
+    switch (conv.kind) {
+    case kLogArgNone:
+      continue;
+    case kLogArgInt:
+      arg = (uint64_t)(int64_t)va_arg(ap, int);
+      break;
+    case kLogArgLong:
+      arg = (uint64_t)(int64_t)va_arg(ap, long);
+      break;
+    case kLogArgLongLong:
+      arg = (uint64_t)va_arg(ap, long long);
+      break;
+    case kLogArgIntmax:
+      arg = (uint64_t)va_arg(ap, intmax_t);
+      break;
+    case kLogArgSize:
+      arg = (uint64_t)va_arg(ap, size_t);
+      break;
+    case kLogArgPtrdiff:
+      arg = (uint64_t)(int64_t)va_arg(ap, ptrdiff_t);
+      break;
+    case kLogArgDouble: {
+      double value = va_arg(ap, double);
+      memcpy(&arg, &value, sizeof(arg));
+      break;
+    }
+    case kLogArgPointer:
+      arg = (uint64_t)(uintptr_t)va_arg(ap, void *);
+      break;
+    case kLogArgString: {
+      // the string may not outlive the call, keep a copy in the record
+      const char *str = va_arg(ap, const char *);
+      if (str == nullptr)
+        str = "(null)";
+      if (strings_size - strings_len <= sizeof(LOG_ASYNC_STRING_CUT)) {
+        arg = strings_size;
+        break;
+      }
+      size_t room = strings_size - strings_len - 1;
+      bool cut_by_pool = conv.precision < 0 || (size_t)conv.precision >= room;
+      size_t len = strnlen(str, cut_by_pool ? room : conv.precision);
+      memcpy(record->strings + strings_len, str, len);
+      record->strings[strings_len + len] = '\0';
+      if (cut_by_pool && len == room && str[len] != '\0') {
+        size_t mark_len = sizeof(LOG_ASYNC_STRING_CUT) - 1;
+        memcpy(record->strings + strings_len + len - mark_len, LOG_ASYNC_STRING_CUT, mark_len);
+      }
+      arg = strings_len;
+      strings_len += len + 1;
+      break;
+    }
+    default:
+      return false;
+    }
+    record->args[nargs++] = arg;
+  }
+  return true;
+}
+
+// format a queued message into buffer, with the same conversions as the origin format
+static void log_format_record(LogRecord *record, char *buffer, size_t buffer_size) {
+  size_t len = record->logger->formatPrefix(buffer, buffer_size, record->time);
+  if (len > buffer_size - 2)
+    len = buffer_size - 2;
+  int nargs = 0;
+  for (const char *p = record->fmt; *p && len < buffer_size - 2;) {
+    if (*p != '%') {
+      buffer[len++] = *p++;
+      continue;
+    }
+    LogConversion conv = log_parse_conversion(p + 1);
+
+    // rewrite '*' with the recorded width and precision, a negative precision is taken as none
+    char spec[64];
+    size_t spec_len = 0;
+    for (const char *s = p; s < conv.end && spec_len < sizeof(spec) - 16; s++) {
+      if (*s == '.' && s[1] == '*' && (int64_t)record->args[nargs + conv.stars - 1] < 0) {
+        nargs++;
+        s++;
+        continue;
+      }
+      if (*s == '*') {
+        spec_len += snprintf(spec + spec_len, sizeof(spec) - spec_len, "%d", (int)(int64_t)record->args[nargs++]);
+        continue;
+      }
+      spec[spec_len++] = *s;
+    }
+    spec[spec_len] = '\0';
+    p = conv.end;
+
+    char *out = buffer + len;
+    size_t room = buffer_size - len - 1;
+    uint64_t arg = conv.kind == kLogArgNone ? 0 : record->args[nargs++];
+    int n = 0;
+    switch (conv.kind) {
+    case kLogArgNone:
+      n = snprintf(out, room, "%%");
+      break;
+    case kLogArgInt:
+      n = snprintf(out, room, spec, (int)arg);
+      break;
+    case kLogArgLong:
+      n = snprintf(out, room, spec, (long)arg);
+      break;
+    case kLogArgLongLong:
+      n = snprintf(out, room, spec, (long long)arg);
+      break;
+    case kLogArgIntmax:
+      n = snprintf(out, room, spec, (intmax_t)arg);
+      break;
+    case kLogArgSize:
+      n = snprintf(out, room, spec, (size_t)arg);
+      break;
+    case kLogArgPtrdiff:
+      n = snprintf(out, room, spec, (ptrdiff_t)arg);
+      break;
+    case kLogArgDouble: {
+      double value;
+      memcpy(&value, &arg, sizeof(value));
+      n = snprintf(out, room, spec, value);
+      break;
+    }
+    case kLogArgPointer:
+      n = snprintf(out, room, spec, (void *)(uintptr_t)arg);
+      break;
+    case kLogArgString:
+      n = snprintf(out, room, spec, record->strings + arg);
+      break;
+    default:
+      break;
+    }
+    if (n > 0)
+      len += (size_t)n < room ? n : room - 1;
+  }
+  buffer[len++] = '\n';
+  buffer[len] = '\0';
+}
+
+static void log_queue_reset() {
+  for (size_t i = 0; i < LOG_ASYNC_QUEUE_SIZE; i++)
+    log_queue_[i].sequence = i;
+  log_enqueue_pos_ = 0;
+  log_dequeue_pos_ = 0;
+  log_written_pos_ = 0;
+}
+
+// write the queued messages, returns how many
+static int log_queue_drain() {
+  int count = 0;
+  size_t pos = __atomic_load_n(&log_dequeue_pos_, __ATOMIC_RELAXED);
+  for (;;) {
+    LogCell *cell = &log_queue_[pos & (LOG_ASYNC_QUEUE_SIZE - 1)];
+    size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+    intptr_t diff = (intptr_t)sequence - (intptr_t)(pos + 1);
+    if (diff < 0)
+      break;
+    if (diff > 0) {
+      pos = __atomic_load_n(&log_dequeue_pos_, __ATOMIC_RELAXED);
+      continue;
+    }
+    if (!__atomic_compare_exchange_n(&log_dequeue_pos_, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      continue;
+
+    char buffer[4096];
+    log_format_record(&cell->record, buffer, sizeof(buffer));
+    Logger *logger = cell->record.logger;
+    __atomic_store_n(&cell->sequence, pos + LOG_ASYNC_QUEUE_SIZE, __ATOMIC_RELEASE);
+    logger->writeMessage(buffer);
+    count++;
+    __atomic_store_n(&log_written_pos_, pos + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&log_flush_waiters_, __ATOMIC_SEQ_CST)) {
+      pthread_mutex_lock(&log_consumer_mutex_);
+      pthread_cond_broadcast(&log_flush_cond_);
+      pthread_mutex_unlock(&log_consumer_mutex_);
+    }
+    pos = __atomic_load_n(&log_dequeue_pos_, __ATOMIC_RELAXED);
+  }
+
+  size_t dropped = __atomic_exchange_n(&log_dropped_, 0, __ATOMIC_RELAXED);
+  if (dropped) {
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "[logging] %zu messages dropped\n", dropped);
+    Logger::Shared()->writeMessage(buffer);
+  }
+  return count;
+}
+
+static void *log_consumer(void *) {
+  for (;;) {
+    if (log_queue_drain())
+      continue;
+
+    pthread_mutex_lock(&log_consumer_mutex_);
+    __atomic_store_n(&log_consumer_waiting_, true, __ATOMIC_SEQ_CST);
+    // a producer which missed the waiting flag published before this check
+    size_t pos = __atomic_load_n(&log_dequeue_pos_, __ATOMIC_SEQ_CST);
+    size_t sequence = __atomic_load_n(&log_queue_[pos & (LOG_ASYNC_QUEUE_SIZE - 1)].sequence, __ATOMIC_SEQ_CST);
+    if (sequence != pos + 1 && !__atomic_load_n(&log_dropped_, __ATOMIC_RELAXED))
+      pthread_cond_wait(&log_consumer_cond_, &log_consumer_mutex_);
+    __atomic_store_n(&log_consumer_waiting_, false, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&log_consumer_mutex_);
+  }
+  return nullptr;
+}
+
+static bool log_consumer_start() {
+  if (__atomic_exchange_n(&log_consumer_started_, true, __ATOMIC_ACQ_REL))
+    return true;
+
+  pthread_t thread;
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  int ret = pthread_create(&thread, &attr, log_consumer, nullptr);
+  pthread_attr_destroy(&attr);
+  if (ret != 0) {
+    __atomic_store_n(&log_consumer_started_, false, __ATOMIC_RELEASE);
+    return false;
+  }
+  return true;
+}
+
+// the child has no logging thread, and the messages queued in the parent are written by the parent
+static void log_atfork_child() {
+  log_queue_reset();
+  log_dropped_ = 0;
+  log_consumer_started_ = false;
+  log_consumer_waiting_ = false;
+  log_flush_waiters_ = 0;
+  pthread_mutex_init(&log_consumer_mutex_, nullptr);
+  pthread_cond_init(&log_consumer_cond_, nullptr);
+  pthread_cond_init(&log_flush_cond_, nullptr);
+}
+
+static void log_async_init() {
+  log_queue_reset();
+  pthread_atfork(nullptr, nullptr, log_atfork_child);
+}
+
+static bool log_async_record(Logger *logger, const char *fmt, va_list ap) {
+  if (!__atomic_load_n(&log_consumer_started_, __ATOMIC_ACQUIRE) && !log_consumer_start())
+    return false;
+
+  LogRecord record;
+  va_list ap_copy;
+  va_copy(ap_copy, ap);
+  bool captured = log_capture_args(&record, fmt, ap_copy);
+  va_end(ap_copy);
+  if (!captured)
+    return false;
+  record.logger = logger;
+  record.fmt = fmt;
+  record.time = time(NULL);
+
+  size_t pos = __atomic_load_n(&log_enqueue_pos_, __ATOMIC_RELAXED);
+  LogCell *cell;
+  for (;;) {
+    cell = &log_queue_[pos & (LOG_ASYNC_QUEUE_SIZE - 1)];
+    size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+    intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+    if (diff < 0) {
+      __atomic_fetch_add(&log_dropped_, 1, __ATOMIC_RELAXED);
+      return true;
+    }
+    if (diff == 0 &&
+        __atomic_compare_exchange_n(&log_enqueue_pos_, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+      break;
+    if (diff > 0)
+      pos = __atomic_load_n(&log_enqueue_pos_, __ATOMIC_RELAXED);
+  }
+  memcpy(&cell->record, &record, sizeof(record));
+  __atomic_store_n(&cell->sequence, pos + 1, __ATOMIC_SEQ_CST);
+
+  if (__atomic_load_n(&log_consumer_waiting_, __ATOMIC_SEQ_CST)) {
+    pthread_mutex_lock(&log_consumer_mutex_);
+    pthread_cond_signal(&log_consumer_cond_);
+    pthread_mutex_unlock(&log_consumer_mutex_);
+  }
+  return true;
+}
+
+void Logger::enableAsync() {
+  static pthread_once_t once = PTHREAD_ONCE_INIT;
+  pthread_once(&once, log_async_init);
+  if (log_consumer_start())
+    enable_async_ = true;
+}
+
+void Logger::disableAsync() {
+  enable_async_ = false;
+  flush();
+}
+
+void Logger::flush() {
+  // without a logging thread, such as in a forked child, the caller writes them
+  if (!__atomic_load_n(&log_consumer_started_, __ATOMIC_ACQUIRE)) {
+    log_queue_drain();
+    return;
+  }
+
+  // wait for the logging thread to write the messages queued so far, writing them here would interleave with it
+  size_t flush_pos = __atomic_load_n(&log_enqueue_pos_, __ATOMIC_SEQ_CST);
+  pthread_mutex_lock(&log_consumer_mutex_);
+  __atomic_fetch_add(&log_flush_waiters_, 1, __ATOMIC_SEQ_CST);
+  while ((intptr_t)(__atomic_load_n(&log_written_pos_, __ATOMIC_SEQ_CST) - flush_pos) < 0) {
+    // the logging thread may be idle before the last producer signaled it
+    pthread_cond_signal(&log_consumer_cond_);
+    pthread_cond_wait(&log_flush_cond_, &log_consumer_mutex_);
+  }
+  __atomic_fetch_sub(&log_flush_waiters_, 1, __ATOMIC_SEQ_CST);
+  pthread_mutex_unlock(&log_consumer_mutex_);
+}
+
+#else
+
+static bool log_async_record(Logger *, const char *, va_list) {
+  return false;
+}
+
+void Logger::enableAsync() {
+}
+
+void Logger::disableAsync() {
+}
+
+void Logger::flush() {
+}
+
+#endif
+
 #pragma clang diagnostic warning "-Wformat"
 
 void *logger_create(const char *tag, const char *file, LogLevel level, bool enable_time_tag, bool enable_syslog) {
@@ -134,4 +694,14 @@ void logger_log_impl(void *logger, LogLevel level, const char *fmt, ...) {
   va_start(ap, fmt);
   ((Logger *)logger)->logv(level, fmt, ap);
   va_end(ap);
-}
\ No newline at end of file
+}
+
+void logger_enable_async(void *logger, bool enable) {
+  if (logger == nullptr) {
+    logger = Logger::Shared();
+  }
+  if (enable)
+    ((Logger *)logger)->enableAsync();
+  else
+    ((Logger *)logger)->disableAsync();
+}
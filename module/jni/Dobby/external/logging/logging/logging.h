@@ -4,6 +4,7 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <time.h>
 
 #define LOG_TAG NULL
 
@@ -36,6 +37,7 @@ public:
 
   bool enable_time_tag_;
   bool enable_syslog_;
+  bool enable_async_;
 
   static Logger *g_logger;
   static Logger *Shared() {
@@ -51,6 +53,7 @@ public:
     log_level_ = LOG_LEVEL_DEBUG;
     enable_time_tag_ = false;
     enable_syslog_ = false;
+    enable_async_ = false;
   }
 
   Logger(const char *tag, const char *file, LogLevel level, bool enable_time_tag, bool enable_syslog) {
@@ -59,6 +62,7 @@ public:
     setLogLevel(level);
     enable_time_tag_ = enable_time_tag;
     enable_syslog_ = enable_syslog;
+    enable_async_ = false;
   }
 
   void setOptions(const char *tag, const char *file, LogLevel level, bool enable_time_tag, bool enable_syslog) {
@@ -97,8 +101,26 @@ public:
     enable_syslog_ = true;
   }
 
+  // record the format and arguments into a lock-free queue, a logging thread formats and writes them.
+  // Fatal messages and formats with %n, %m, wide or long double conversions are written synchronously after the queued
+  // ones, messages are dropped while the queue is full. %s arguments are copied into a small pool, a cut string ends
+  // with "...". The thread is restarted in a forked child
+  void enableAsync();
+
+  // wait for the queued messages and log synchronously again
+  void disableAsync();
+
+  // wait until the logging thread wrote the messages queued before the call
+  void flush();
+
   void logv(LogLevel level, const char *fmt, va_list ap);
 
+  // "<tag> <time> " prefix of a message
+  int formatPrefix(char *buffer, size_t buffer_size, time_t now);
+
+  // write a formatted message to the sinks
+  void writeMessage(const char *message);
+
   void log(LogLevel level, const char *fmt, ...) {
     va_list ap;
     va_start(ap, fmt);
@@ -161,6 +183,9 @@ void logger_set_options(void *logger, const char *tag, const char *file, LogLeve
                         bool enable_syslog);
 void logger_log_impl(void *logger, LogLevel level, const char *fmt, ...);
 
+// see Logger::enableAsync
+void logger_enable_async(void *logger, bool enable);
+
 #ifdef __cplusplus
 }
 #endif
@@ -121,30 +121,149 @@ typedef struct {
 int DobbyCodePatch(void *address, uint8_t *buffer, uint32_t buffer_size);
 
 // function inline hook
+// hooking a hooked address chains replace_func in front of the latest one, origin_func calls the hooks below
 int DobbyHook(void *address, dobby_dummy_func_t replace_func, dobby_dummy_func_t *origin_func);
 
+// split DobbyHook, prepare relocates the prologue and builds the trampoline without patching,
+// commit only patches the trampoline, such as prepare before fork and commit in the child.
+// origin_func is usable after prepare, discard a prepared hook with DobbyDestroy
+int DobbyPrepare(void *address, dobby_dummy_func_t replace_func, dobby_dummy_func_t *origin_func);
+int DobbyCommit(void *address);
+
 // dynamic binary instruction instrument
 // for Arm64, can't access q8 - q31, unless enable full floating-point register pack
+// instrumenting an instrumented address adds a listener to its trampoline, listeners run in the order added
 typedef void (*dobby_instrument_callback_t)(void *address, DobbyRegisterContext *ctx);
 int DobbyInstrument(void *address, dobby_instrument_callback_t pre_handler);
 
-// destroy and restore code patch
+// registers live at an instrument point, for Arm64 bit n is xn (x0 - x30) and bit 32 + n is qn (q0 - q31)
+#define DOBBY_REG_MASK_X(n) (1ULL << (n))
+#define DOBBY_REG_MASK_Q(n) (1ULL << (32 + (n)))
+#define DOBBY_REG_MASK_ALL (~0ULL)
+
+// instrument through a bridge built for this address, which saves only the registers in register_mask and calls
+// pre_handler directly. Other registers are undefined in ctx and not preserved across pre_handler, only leave out
+// registers that are dead at the address, such as x9 - x15, q0 - q7 and the flags at a function entry without FP
+// arguments. sp and lr are always valid.
+// Arm64 only, other architectures fall back to DobbyInstrument. An address instrumented with a mask takes no more
+// listeners, a mask on an already instrumented address is ignored
+int DobbyInstrumentWithRegisterMask(void *address, dobby_instrument_callback_t pre_handler, uint64_t register_mask);
+
+// per call slots, zeroed before on_enter and handed to on_leave of the same call, such as an entry timestamp
+#define DOBBY_INSTRUMENT_CONTEXT_SLOTS 4
+typedef struct {
+  uintptr_t slots[DOBBY_INSTRUMENT_CONTEXT_SLOTS];
+} DobbyInstrumentContext;
+
+typedef void (*dobby_instrument_enter_callback_t)(void *address, DobbyRegisterContext *ctx,
+                                                  DobbyInstrumentContext *user_ctx);
+typedef void (*dobby_instrument_leave_callback_t)(void *address, DobbyRegisterContext *ctx,
+                                                  DobbyInstrumentContext *user_ctx);
+
+// instrument a function entry with on_enter before it runs and on_leave after it returns, ctx holds the return value
+// registers in on_leave. The return address is kept on a fixed size per thread shadow stack, calls nested deeper than
+// it run on_enter only. Either callback may be NULL, an address takes one on_leave listener
+int DobbyInstrumentEnterLeave(void *address, dobby_instrument_enter_callback_t on_enter,
+                              dobby_instrument_leave_callback_t on_leave);
+
+// count hits of address with an atomic increment of *counter, without a register context or handler call
+int DobbyInstrumentCounter(void *address, uint64_t *counter);
+
+// run pre_handler on about one call out of every_nth, at most once per interval_ns on each thread (0 for no limit)
+int DobbyInstrumentSampled(void *address, dobby_instrument_callback_t pre_handler, uint32_t every_nth,
+                           uint64_t interval_ns);
+
+// destroy and restore code patch, for chained hooks only the latest one is removed
 int DobbyDestroy(void *address);
 
+// remove the hook of replace_func from address, the code patch is restored with the last hook
+int DobbyDestroyHook(void *address, dobby_dummy_func_t replace_func);
+
+// the near kinds are tried first on Arm64 unless dobby_disable_near_branch_trampoline
+typedef enum {
+  kDobbyTrampolineNone = 0,
+  // single branch to the routing target
+  kDobbyTrampolineNearBranch,
+  // single branch to a shared near veneer
+  kDobbyTrampolineNearVeneer,
+  // absolute indirect branch, such as [adrp, add, br] or [ldr, br, #label]
+  kDobbyTrampolineAbsolute,
+} DobbyTrampolineKind;
+
+// trampoline encoding used by the hook at address, patch_size receives the patched prologue size
+// @Return: -1 if the address is not hooked
+int DobbyGetTrampolineKind(void *address, DobbyTrampolineKind *kind, uint32_t *patch_size);
+
+// count and time the hooks prepared while enabled, replace_func then returns through a stats bridge
+void dobby_enable_hook_stats();
+void dobby_disable_hook_stats();
+
+// latency histogram, bucket i >= 4 counts from (4 + i % 4) << (i / 4 - 1) ns
+#define DOBBY_HOOK_STATS_BUCKETS 128
+#define DOBBY_HOOK_STATS_THREADS 16
+
+typedef struct {
+  uint64_t hits;
+  // calls returned through the stats bridge
+  uint64_t timed_calls;
+  uint64_t total_ns;
+  uint64_t max_ns;
+  uint64_t histogram[DOBBY_HOOK_STATS_BUCKETS];
+  // in the order of the first call, a shared slot keeps its last tid
+  struct {
+    int tid;
+    uint64_t hits;
+  } threads[DOBBY_HOOK_STATS_THREADS];
+} DobbyHookStats;
+
+// aggregate the per thread statistics of the hook at address
+// @Return: -1 if the address is not hooked with statistics
+int DobbyGetHookStats(void *address, DobbyHookStats *stats);
+
+// name the generated code in <dir>/perf-<pid>.map for perf, NULL dir is /data/local/tmp on Android and /tmp otherwise
+void dobby_enable_perf_map(const char *dir);
+void dobby_disable_perf_map();
+
 const char *DobbyGetVersion();
 
 // symbol resolver
 void *DobbySymbolResolver(const char *image_name, const char *symbol_name);
 
+// resolve multiple symbols with a single pass over each symbol table
+// @out: resolved address for each name, NULL if not found
+// @Return: the number of unresolved symbols
+int DobbySymbolResolverBatch(const char *image_name, const char **symbol_names, void **out, int count);
+
+typedef struct {
+  const char *name;
+  void *address;
+} DobbySymbolMatch;
+
+// resolve the symbols matching the glob pattern, support '*' and '?', such as "_ZN3art*"
+// MiniDebugInfo is only searched when no symbol table matches, the latest 4096 matched names stay valid
+// @Return: the number of matched symbols written to matches, the scan stops at max_count
+int DobbySymbolResolverMatch(const char *image_name, const char *pattern, DobbySymbolMatch *matches, int max_count);
+
+// scan the modules with a worker pool when the symbol is not exported
+// never enable in zygote, the workers are created per lookup and joined before return
+void dobby_enable_parallel_symbol_resolver(int worker_count);
+void dobby_disable_parallel_symbol_resolver();
+
 // import table replace
 int DobbyImportTableReplace(char *image_name, char *symbol_name, dobby_dummy_func_t fake_func,
                             dobby_dummy_func_t *orig_func);
 
 // for arm, Arm64, try use b xxx instead of ldr absolute indirect branch
 // for x86, x64, always use absolute indirect jump
+// Arm64 tries it by default, disable it to always use the absolute one
 void dobby_enable_near_branch_trampoline();
 void dobby_disable_near_branch_trampoline();
 
+// scan the hooked function for branches back into the patched prologue before patching,
+// the hook fails if no trampoline short enough is available, Arm64 only
+void dobby_enable_function_scan();
+void dobby_disable_function_scan();
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,22 +1,9 @@
-#include "MultiThreadSupport/ThreadSupport.h"
+#include "Backend/UserMode/MultiThreadSupport/ThreadSupport.h"
 
-using namespace zz;
-
-OSThread::LocalStorageKey ThreadSupport::thread_callstack_key_ = 0;
+// zero initialized, the thread library allocates it once per thread
+static thread_local CallStack thread_callstack_;
 
 // Get current CallStack
 CallStack *ThreadSupport::CurrentThreadCallStack() {
-
-  // TODO: __attribute__((destructor)) is better ?
-  if (!thread_callstack_key_) {
-    thread_callstack_key_ = OSThread::CreateThreadLocalKey();
-  }
-
-  if (OSThread::HasThreadLocal(thread_callstack_key_)) {
-    return static_cast<CallStack *>(OSThread::GetThreadLocal(thread_callstack_key_));
-  } else {
-    CallStack *callstack = new CallStack();
-    OSThread::SetThreadLocal(thread_callstack_key_, callstack);
-    return callstack;
-  }
+  return &thread_callstack_;
 }
@@ -1,63 +1,70 @@
 #ifndef USER_MODE_MULTI_THREAD_SUPPORT_H
 #define USER_MODE_MULTI_THREAD_SUPPORT_H
 
-#include <vector>
-#include <map>
-
 #include "dobby/dobby_internal.h"
 
-#include "source/Backend/UserMode/Thread/PlatformThread.h"
+// frames per thread, deeper calls still run the enter callback but skip the leave callback
+#define SHADOW_STACK_DEPTH 64
 
 // StackFrame base in CallStack
 typedef struct _StackFrame {
-  // context between `pre_call` and `post_call`
-  std::map<char *, void *> kv_context;
+  InterceptEntry *entry;
+  // stack pointer of the caller once the origin function returns
+  addr_t sp;
   // origin function ret address
   void *orig_ret;
+  // ret address installed in place of orig_ret
+  void *ret_bridge;
+  // context between `pre_call` and `post_call`
+  DobbyInstrumentContext user_ctx;
 } StackFrame;
 
-// (thead) CallStack base in thread
+// (thead) CallStack base in thread, preallocated in thread local storage
 typedef struct _CallStack {
-  tinystl::vector<StackFrame *> stackframes;
+  uint32_t depth;
+  StackFrame stackframes[SHADOW_STACK_DEPTH];
 } CallStack;
 
-// ThreadSupport base on vm_core, support mutipl platforms.
 class ThreadSupport {
 public:
-  // Push stack frame
-  static void PushStackFrame(StackFrame *stackframe) {
-    CallStack *callstack = ThreadSupport::CurrentThreadCallStack();
-    callstack->stackframes.push_back(stackframe);
-  }
-
-  // Pop stack frame
-  static StackFrame *PopStackFrame() {
+  // Push stack frame of a function entered with ret_address and returning with the caller stack pointer sp, nullptr if
+  // the shadow stack is full
+  static StackFrame *PushStackFrame(addr_t sp, void *ret_address) {
     CallStack *callstack = ThreadSupport::CurrentThreadCallStack();
-    StackFrame *stackframe = callstack->stackframes.back();
-    callstack->stackframes.pop_back();
+    // frames as deep as a new call were left by a longjmp, unless the new call is a tail call returning through them
+    while (callstack->depth > 0) {
+      StackFrame *top = &callstack->stackframes[callstack->depth - 1];
+      if (top->sp < sp || (top->sp == sp && top->ret_bridge != ret_address))
+        callstack->depth--;
+      else
+        break;
+    }
+    if (callstack->depth == SHADOW_STACK_DEPTH)
+      return nullptr;
+    StackFrame *stackframe = &callstack->stackframes[callstack->depth++];
+    stackframe->sp = sp;
+    memset(&stackframe->user_ctx, 0, sizeof(DobbyInstrumentContext));
     return stackframe;
   }
 
-  // =====
-  static void SetStackFrameContextValue(StackFrame *stackframe, char *key, void *value) {
-    std::map<char *, void *> *kv_context = &stackframe->kv_context;
-    kv_context->insert(std::pair<char *, void *>(key, value));
-  };
-
-  static void *GetStackFrameContextValue(StackFrame *stackframe, char *key) {
-    std::map<char *, void *> kv_context = stackframe->kv_context;
-    std::map<char *, void *>::iterator it;
-    it = kv_context.find(key);
-    if (it != kv_context.end()) {
-      return (void *)it->second;
+  // Pop the frame of the function returning with the caller stack pointer sp, frames above it were skipped by a
+  // longjmp. The frame stays valid until the next push
+  static StackFrame *PopStackFrame(addr_t sp) {
+    CallStack *callstack = ThreadSupport::CurrentThreadCallStack();
+    if (callstack->depth == 0)
+      return nullptr;
+    // a skipped frame is deeper than the returning one, the returning frame may be below sp on callee-pop returns
+    while (callstack->depth > 1) {
+      StackFrame *top = &callstack->stackframes[callstack->depth - 1];
+      if (top->sp < sp && (top - 1)->sp <= sp)
+        callstack->depth--;
+      else
+        break;
     }
-    return NULL;
-  };
+    return &callstack->stackframes[--callstack->depth];
+  }
 
   static CallStack *CurrentThreadCallStack();
-
-private:
-  static zz::OSThread::LocalStorageKey thread_callstack_key_;
 };
 
 #endif
@@ -109,6 +109,7 @@ static tinystl::vector<RuntimeModule> &get_process_map_with_proc_maps() {
   if (modules == nullptr) {
     modules = new tinystl::vector<RuntimeModule>();
   }
+  modules->clear();
 
   FILE *fp = fopen("/proc/self/maps", "r");
   if (fp == nullptr)
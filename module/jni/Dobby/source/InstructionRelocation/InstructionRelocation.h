@@ -3,3 +3,7 @@
 void GenRelocateCode(void *buffer, CodeMemBlock *origin, CodeMemBlock *relocated, bool branch);
 
 void GenRelocateCodeAndBranch(void *buffer, CodeMemBlock *origin, CodeMemBlock *relocated);
+
+// scan the function body for branches into (buffer, buffer + patch_size), reading at most scan_size bytes
+// @Return: the lowest branch target offset inside the patch range, 0 if none
+uint32_t GenScanFunctionBranchTarget(void *buffer, uint32_t patch_size, uint32_t scan_size);
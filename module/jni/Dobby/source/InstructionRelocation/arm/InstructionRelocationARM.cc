@@ -848,6 +848,206 @@ void gen_thumb_relocate_code(relo_ctx_t *ctx) {
   }
 }
 
+// ---
+
+typedef enum {
+  kThumbFastUnsupported,
+  // position independent, copied as is
+  kThumbFastCopy,
+  // ldr rt, [pc, #imm], needs the literal address fixed up
+  kThumbFastLiteralLdr,
+} thumb_fast_insn_kind_t;
+
+static bool thumb_fast_relocation_enabled = true;
+
+void set_thumb_fast_relocation_enabled(bool enabled) {
+  thumb_fast_relocation_enabled = enabled;
+}
+
+static thumb_fast_insn_kind_t thumb1_fast_insn_kind(uint16_t insn) {
+  // shift, add, sub, mov, cmp (immediate) and data processing on low registers
+  if ((insn & 0xfc00) < 0x4400)
+    return kThumbFastCopy;
+
+  // add, cmp, mov on high registers, neither of them pc
+  if ((insn & 0xff00) >= 0x4400 && (insn & 0xff00) <= 0x4600) {
+    uint32_t rm = bits(insn, 3, 6);
+    uint32_t rdn = (bit(insn, 7) << 3) | bits(insn, 0, 2);
+    return (rm == 15 || rdn == 15) ? kThumbFastUnsupported : kThumbFastCopy;
+  }
+
+  // ldr literal
+  if ((insn & 0xf800) == 0x4800)
+    return kThumbFastLiteralLdr;
+
+  // load / store register, immediate and sp relative
+  if (insn >= 0x5000 && insn < 0xa000)
+    return kThumbFastCopy;
+
+  // add rd, sp, #imm
+  if ((insn & 0xf800) == 0xa800)
+    return kThumbFastCopy;
+
+  // add / sub sp, extend, push, reverse, pop
+  uint32_t misc_op = bits(insn, 8, 11);
+  if ((insn & 0xf000) == 0xb000) {
+    switch (misc_op) {
+    case 0b0000:
+    case 0b0010:
+    case 0b0100:
+    case 0b0101:
+    case 0b1010:
+    case 0b1100:
+    case 0b1101:
+      return kThumbFastCopy;
+    case 0b1111:
+      // nop hints, but no it block
+      return bits(insn, 0, 3) == 0 ? kThumbFastCopy : kThumbFastUnsupported;
+    default:
+      return kThumbFastUnsupported;
+    }
+  }
+
+  // stm / ldm
+  if ((insn & 0xf000) == 0xc000)
+    return kThumbFastCopy;
+
+  return kThumbFastUnsupported;
+}
+
+static thumb_fast_insn_kind_t thumb2_fast_insn_kind(uint16_t insn1, uint16_t insn2) {
+  uint32_t rn = bits(insn1, 0, 3);
+
+  // ldm / stm (push.w, pop.w)
+  if ((insn1 & 0xfe40) == 0xe800) {
+    uint32_t op = bits(insn1, 7, 8);
+    return ((op == 0b01 || op == 0b10) && rn != 15) ? kThumbFastCopy : kThumbFastUnsupported;
+  }
+
+  // ldrd / strd (immediate), not ldrex / tbb
+  if ((insn1 & 0xfe40) == 0xe840) {
+    bool is_pre_or_wback = bit(insn1, 8) || bit(insn1, 5);
+    return (is_pre_or_wback && rn != 15) ? kThumbFastCopy : kThumbFastUnsupported;
+  }
+
+  // data processing (shifted register)
+  if ((insn1 & 0xfe00) == 0xea00)
+    return bits(insn2, 0, 3) == 15 ? kThumbFastUnsupported : kThumbFastCopy;
+
+  // data processing (modified immediate), never reads pc
+  if ((insn1 & 0xfa00) == 0xf000 && (insn2 & 0x8000) == 0)
+    return kThumbFastCopy;
+
+  // data processing (plain binary immediate), addw / subw of pc is adr
+  if ((insn1 & 0xfa00) == 0xf200 && (insn2 & 0x8000) == 0) {
+    uint32_t op = bits(insn1, 4, 8);
+    bool is_adr = (op == 0b00000 || op == 0b01010) && rn == 15;
+    return is_adr ? kThumbFastUnsupported : kThumbFastCopy;
+  }
+
+  // ldr.w literal, rt neither sp nor pc
+  if ((insn1 & 0xff7f) == 0xf85f) {
+    uint32_t rt = bits(insn2, 12, 15);
+    return (rt == 13 || rt == 15) ? kThumbFastUnsupported : kThumbFastLiteralLdr;
+  }
+
+  // load / store single
+  if ((insn1 & 0xfe00) == 0xf800)
+    return rn == 15 ? kThumbFastUnsupported : kThumbFastCopy;
+
+  // data processing (register), multiply
+  if ((insn1 & 0xfe00) == 0xfa00)
+    return bits(insn2, 0, 3) == 15 ? kThumbFastUnsupported : kThumbFastCopy;
+
+  // vpush, vpop, vstr, vldr, but no vldr literal
+  if ((insn1 & 0xfe00) == 0xec00)
+    return rn == 15 ? kThumbFastUnsupported : kThumbFastCopy;
+
+  // vfp / simd data processing
+  if ((insn1 & 0xfe00) == 0xee00)
+    return kThumbFastCopy;
+
+  return kThumbFastUnsupported;
+}
+
+// Common thumb prologues (push, sub sp, mov, ldr literal, ...) are position independent except for literal loads.
+// Copy the runs between literal loads as is and rewrite only the literal loads, skip the per-insn relocation.
+// Returns false without emitting anything if any instruction needs the generic path.
+bool gen_thumb_fast_relocate_code(relo_ctx_t *ctx) {
+  if (!thumb_fast_relocation_enabled)
+    return false;
+
+  uint8_t *buffer_end = ctx->buffer + ctx->buffer_size;
+
+  // scan
+  uint8_t *cursor = ctx->buffer;
+  while (cursor < buffer_end) {
+    thumb2_inst_t insn = *(thumb2_inst_t *)cursor;
+    thumb_fast_insn_kind_t kind;
+    if (is_thumb2(insn)) {
+      kind = thumb2_fast_insn_kind((uint16_t)insn, (uint16_t)(insn >> 16));
+      cursor += Thumb2_INST_LEN;
+    } else {
+      kind = thumb1_fast_insn_kind((uint16_t)insn);
+      cursor += Thumb1_INST_LEN;
+    }
+    if (kind == kThumbFastUnsupported)
+      return false;
+  }
+  buffer_end = cursor;
+
+  auto turbo_assembler_ = static_cast<ThumbTurboAssembler *>(ctx->curr_assembler);
+#define _ turbo_assembler_->
+  auto relocated_buffer = reinterpret_cast<CodeBufferBase *>(turbo_assembler_->GetCodeBuffer());
+
+  DEBUG_LOG("[arm] Thumb fast relocate %d start >>>>>", buffer_end - ctx->buffer);
+
+  uint8_t *copy_start = ctx->buffer;
+  while (ctx->buffer_cursor < buffer_end) {
+    thumb2_inst_t insn = *(thumb2_inst_t *)ctx->buffer_cursor;
+    bool is_insn_thumb2 = is_thumb2(insn);
+    int insn_len = is_insn_thumb2 ? Thumb2_INST_LEN : Thumb1_INST_LEN;
+
+    thumb_fast_insn_kind_t kind = is_insn_thumb2 ? thumb2_fast_insn_kind((uint16_t)insn, (uint16_t)(insn >> 16))
+                                                 : thumb1_fast_insn_kind((uint16_t)insn);
+    if (kind == kThumbFastLiteralLdr) {
+      if (ctx->buffer_cursor > copy_start)
+        relocated_buffer->EmitBuffer(copy_start, ctx->buffer_cursor - copy_start);
+
+      addr_t pc_vmaddr = ALIGN_FLOOR(relo_cur_src_vmaddr(ctx), 4);
+      addr_t dst_vmaddr = 0;
+      uint32_t rt = 0;
+      if (is_insn_thumb2) {
+        thumb1_inst_t insn1 = (uint16_t)insn, insn2 = (uint16_t)(insn >> 16);
+        uint32_t imm12 = bits(insn2, 0, 11);
+        dst_vmaddr = bit(insn1, 7) ? pc_vmaddr + imm12 : pc_vmaddr - imm12;
+        rt = bits(insn2, 12, 15);
+      } else {
+        dst_vmaddr = pc_vmaddr + (bits(insn, 0, 7) << 2);
+        rt = bits(insn, 8, 10);
+      }
+
+      DEBUG_LOG("%d:relo <thumb fast: ldr literal> at %p", ctx->buffer_cursor - ctx->buffer, dst_vmaddr);
+
+      auto label = ThumbRelocLabelEntry::withData(dst_vmaddr, false);
+      _ AppendRelocLabel(label);
+
+      _ AlignThumbNop();
+      _ T2_Ldr(Register::R(rt), label);
+      _ t2_ldr(Register::R(rt), MemOperand(Register::R(rt), 0));
+
+      copy_start = ctx->buffer_cursor + insn_len;
+    }
+
+    ctx->buffer_cursor += insn_len;
+  }
+
+  if (ctx->buffer_cursor > copy_start)
+    relocated_buffer->EmitBuffer(copy_start, ctx->buffer_cursor - copy_start);
+
+  return true;
+}
+
 void GenRelocateCode(void *buffer, CodeMemBlock *origin, CodeMemBlock *relocated, bool branch) {
   relo_ctx_t ctx;
 
@@ -867,8 +1067,8 @@ void GenRelocateCode(void *buffer, CodeMemBlock *origin, CodeMemBlock *relocated
   ctx.src_vmaddr = (addr_t)origin->addr;
   ctx.dst_vmaddr = 0;
 
-  auto *relocated_buffer = new CodeBuffer();
-  ctx.relocated_buffer = relocated_buffer;
+  CodeBuffer relocated_buffer;
+  ctx.relocated_buffer = &relocated_buffer;
 
   ThumbTurboAssembler thumb_turbo_assembler_(0, ctx.relocated_buffer);
 #define thumb_ thumb_turbo_assembler_.
@@ -883,7 +1083,9 @@ void GenRelocateCode(void *buffer, CodeMemBlock *origin, CodeMemBlock *relocated
 relocate_remain:
   if (ctx.curr_state == ThumbExecuteState) {
     ctx.curr_assembler = &thumb_turbo_assembler_;
-    gen_thumb_relocate_code(&ctx);
+    // whole prologue position independent, copy it and fix up the literal loads
+    if (ctx.buffer_cursor != ctx.buffer || !gen_thumb_fast_relocate_code(&ctx))
+      gen_thumb_relocate_code(&ctx);
     if (thumb_turbo_assembler_.GetExecuteState() == ARMExecuteState) {
       // translate interrupt as execute state changed
       bool is_translate_interrupted = ctx.buffer_cursor < ctx.buffer + ctx.buffer_size;
@@ -937,7 +1139,7 @@ relocate_remain:
   // generate executable code
   {
     // assembler without specific memory address
-    auto relocated_mem = MemoryAllocator::SharedAllocator()->allocateExecMemory(relocated_buffer->GetBufferSize());
+    auto relocated_mem = MemoryAllocator::SharedAllocator()->allocateExecMemory(relocated_buffer.GetBufferSize());
     if (relocated_mem == nullptr)
       return;
 
@@ -945,7 +1147,7 @@ relocate_remain:
     arm_turbo_assembler_.SetRealizedAddress((void *)relocated_mem);
 
     AssemblyCode *code = NULL;
-    code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(ctx.curr_assembler);
+    code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(ctx.curr_assembler, "relocated", (addr_t)origin->addr);
     relocated->reset(code->addr, code->size);
   }
 
@@ -959,8 +1161,6 @@ relocate_remain:
   {
     thumb_turbo_assembler_.ClearCodeBuffer();
     arm_turbo_assembler_.ClearCodeBuffer();
-
-    delete relocated_buffer;
   }
 }
 
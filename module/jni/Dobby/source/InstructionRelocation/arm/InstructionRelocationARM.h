@@ -305,3 +305,6 @@ void GenRelocateCodeAndBranch(void *buffer, CodeMemBlock *origin, CodeMemBlock *
 
 } // namespace arm
 } // namespace zz
+
+// copy position independent thumb prologues and fix up only their literal loads, enabled by default
+void set_thumb_fast_relocation_enabled(bool enabled);
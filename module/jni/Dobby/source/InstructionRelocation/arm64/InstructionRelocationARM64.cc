@@ -6,6 +6,8 @@
 
 #include "dobby/dobby_internal.h"
 
+#include "MemoryAllocator/PerfMap.h"
+
 #include "core/arch/arm64/registers-arm64.h"
 #include "core/assembler/assembler-arm64.h"
 #include "core/codegen/codegen-arm64.h"
@@ -24,6 +26,23 @@ using namespace zz::arm64;
 #define arm64_trunc_page(x) ((x) & (~(0x1000 - 1)))
 #define arm64_round_page(x) trunc_page((x) + (0x1000 - 1))
 
+// origin_insns of InterceptEntry holds at most 256 bytes
+#define RELO_MAX_INSN_COUNT (256 / sizeof(arm64_inst_t))
+#define RELO_MAX_LABEL_COUNT 8
+
+typedef enum { kReloFixupLiteral64, kReloFixupMov64 } relo_fixup_type_t;
+
+// absolute address in the relocated code, target = src_vmaddr + src_off
+typedef struct {
+  relo_fixup_type_t type;
+  // truncate the target to page, for adrp
+  bool page;
+  int64_t src_off;
+  // buffer offset of the mov sequence, or the literal label bound by RelocBind
+  uint32_t buffer_off;
+  RelocLabel *label;
+} relo_fixup_t;
+
 typedef struct {
   addr_t mapped_addr;
 
@@ -37,9 +56,19 @@ typedef struct {
   CodeMemBlock *origin;
   CodeMemBlock *relocated;
 
-  tinystl::unordered_map<off_t, off_t> relocated_offset_map;
+  int relocated_insn_count;
 
-  tinystl::unordered_map<addr_t, AssemblerPseudoLabel *> label_map;
+  // relocated offset of each origin instruction, indexed by origin offset / 4
+  uint32_t relocated_offset_map[RELO_MAX_INSN_COUNT];
+
+  struct {
+    addr_t addr;
+    AssemblerPseudoLabel *label;
+  } label_map[RELO_MAX_LABEL_COUNT];
+  int label_count;
+
+  relo_fixup_t fixups[RELO_MAX_INSN_COUNT + 1];
+  int fixup_count;
 
 } relo_ctx_t;
 
@@ -64,19 +93,27 @@ addr_t relo_dst_offset_to_vmaddr(relo_ctx_t *ctx, off_t offset) {
 // ---
 
 #if 0
-bool has_relo_label_at(relo_ctx_t *ctx, addr_t addr) {
-  if (ctx->label_map.count(addr)) {
-    return true;
+AssemblerPseudoLabel *relo_label_find(relo_ctx_t *ctx, addr_t addr) {
+  for (int i = 0; i < ctx->label_count; i++) {
+    if (ctx->label_map[i].addr == addr)
+      return ctx->label_map[i].label;
   }
-  return false;
+  return nullptr;
+}
+
+bool has_relo_label_at(relo_ctx_t *ctx, addr_t addr) {
+  return relo_label_find(ctx, addr) != nullptr;
 }
 
 AssemblerPseudoLabel *relo_label_create_or_get(relo_ctx_t *ctx, addr_t addr) {
-  if (!ctx->label_map.count(addr)) {
-    auto *label = new AssemblerPseudoLabel(addr);
-    ctx->label_map[addr] = label;
+  auto *label = relo_label_find(ctx, addr);
+  if (!label) {
+    label = new AssemblerPseudoLabel(addr);
+    ctx->label_map[ctx->label_count].addr = addr;
+    ctx->label_map[ctx->label_count].label = label;
+    ctx->label_count++;
   }
-  return ctx->label_map[addr];
+  return label;
 }
 
 int64_t relo_label_link_offset(relo_ctx_t *ctx, pcrel_type_t pcrel_type, int64_t offset) {
@@ -89,7 +126,7 @@ int64_t relo_label_link_offset(relo_ctx_t *ctx, pcrel_type_t pcrel_type, int64_t
 
   auto is_offset_uninitialized = [ctx](int64_t offset) -> bool {
     if (ctx->buffer_cursor + offset > ctx->buffer && ctx->buffer_cursor + offset < ctx->buffer + ctx->buffer_size) {
-      if (!ctx->relocated_offset_map.count(ctx->buffer_cursor + offset - ctx->buffer_cursor))
+      if (!ctx->relocated_offset_map[(ctx->buffer_cursor + offset - ctx->buffer) / sizeof(arm64_inst_t)])
         return true;
     }
     return false;
@@ -118,209 +155,376 @@ int64_t relo_label_link_offset(relo_ctx_t *ctx, pcrel_type_t pcrel_type, int64_t
 
 // ---
 
-static inline bool inst_is_b_bl(uint32_t instr) {
+static constexpr inline bool inst_is_b_bl(uint32_t instr) {
   return (instr & UnconditionalBranchFixedMask) == UnconditionalBranchFixed;
 }
 
-static inline bool inst_is_ldr_literal(uint32_t instr) {
+static constexpr inline bool inst_is_ldr_literal(uint32_t instr) {
   return ((instr & LoadRegLiteralFixedMask) == LoadRegLiteralFixed);
 }
 
-static inline bool inst_is_adr(uint32_t instr) {
+static constexpr inline bool inst_is_adr(uint32_t instr) {
   return (instr & PCRelAddressingFixedMask) == PCRelAddressingFixed && (instr & PCRelAddressingMask) == ADR;
 }
 
-static inline bool inst_is_adrp(uint32_t instr) {
+static constexpr inline bool inst_is_adrp(uint32_t instr) {
   return (instr & PCRelAddressingFixedMask) == PCRelAddressingFixed && (instr & PCRelAddressingMask) == ADRP;
 }
 
-static inline bool inst_is_b_cond(uint32_t instr) {
+static constexpr inline bool inst_is_b_cond(uint32_t instr) {
   return (instr & ConditionalBranchFixedMask) == ConditionalBranchFixed;
 }
 
-static inline bool inst_is_compare_b(uint32_t instr) {
+static constexpr inline bool inst_is_compare_b(uint32_t instr) {
   return (instr & CompareBranchFixedMask) == CompareBranchFixed;
 }
 
-static inline bool inst_is_test_b(uint32_t instr) {
+static constexpr inline bool inst_is_test_b(uint32_t instr) {
   return (instr & TestBranchFixedMask) == TestBranchFixed;
 }
 
 // ---
 
-int relo_relocate(relo_ctx_t *ctx, bool branch) {
-  int relocated_insn_count = 0;
+typedef enum {
+  kReloInsnOther,
+  kReloInsnBBL,
+  kReloInsnLdrLiteral,
+  kReloInsnAdr,
+  kReloInsnAdrp,
+  kReloInsnBCond,
+  kReloInsnCompareB,
+  kReloInsnTestB,
+  kReloInsnKindCount
+} relo_insn_kind_t;
+
+// every fixed mask above lies in bits [31:24], so the top byte alone decides the kind
+static constexpr uint8_t relo_classify_top_byte(uint32_t top) {
+  return inst_is_b_bl(top << 24)          ? kReloInsnBBL
+         : inst_is_ldr_literal(top << 24) ? kReloInsnLdrLiteral
+         : inst_is_adr(top << 24)         ? kReloInsnAdr
+         : inst_is_adrp(top << 24)        ? kReloInsnAdrp
+         : inst_is_b_cond(top << 24)      ? kReloInsnBCond
+         : inst_is_compare_b(top << 24)   ? kReloInsnCompareB
+         : inst_is_test_b(top << 24)      ? kReloInsnTestB
+                                          : kReloInsnOther;
+}
 
-  TurboAssembler turbo_assembler_(0);
-#define _ turbo_assembler_.
+#define RELO_K1(i) relo_classify_top_byte(i)
+#define RELO_K4(i) RELO_K1(i), RELO_K1(i + 1), RELO_K1(i + 2), RELO_K1(i + 3)
+#define RELO_K16(i) RELO_K4(i), RELO_K4(i + 4), RELO_K4(i + 8), RELO_K4(i + 12)
+#define RELO_K64(i) RELO_K16(i), RELO_K16(i + 16), RELO_K16(i + 32), RELO_K16(i + 48)
+static constexpr uint8_t relo_decode_table[256] = {RELO_K64(0), RELO_K64(64), RELO_K64(128), RELO_K64(192)};
+#undef RELO_K1
+#undef RELO_K4
+#undef RELO_K16
+#undef RELO_K64
+
+static_assert(relo_decode_table[0x94] == kReloInsnBBL, "bl");
+static_assert(relo_decode_table[0x58] == kReloInsnLdrLiteral, "ldr literal");
+static_assert(relo_decode_table[0x90] == kReloInsnAdrp, "adrp");
+static_assert(relo_decode_table[0x54] == kReloInsnBCond, "b.cond");
+static_assert(relo_decode_table[0xd5] == kReloInsnOther, "system");
 
-  auto relocated_buffer = turbo_assembler_.GetCodeBuffer();
+// ---
 
-  while (ctx->buffer_cursor < ctx->buffer + ctx->buffer_size) {
-    uint32_t orig_off = ctx->buffer_cursor - ctx->buffer;
-    uint32_t relocated_off = relocated_buffer->GetBufferSize();
-    ctx->relocated_offset_map[orig_off] = relocated_off;
+static void relo_record_literal_fixup(relo_ctx_t *ctx, RelocLabel *label, addr_t dst_vmaddr) {
+  relo_fixup_t *fixup = &ctx->fixups[ctx->fixup_count++];
+  fixup->type = kReloFixupLiteral64;
+  fixup->page = false;
+  fixup->src_off = (int64_t)(dst_vmaddr - ctx->src_vmaddr);
+  fixup->label = label;
+}
 
-#if 0
-    addr_t inst_vmaddr = 0;
-    inst_vmaddr = relo_cur_src_vmaddr(ctx);
-    if (has_relo_label_at(ctx, inst_vmaddr)) {
-      auto *label = relo_label_create_or_get(ctx, inst_vmaddr);
-      label->bind_to(inst_vmaddr);
+static void relo_record_mov_fixup(relo_ctx_t *ctx, TurboAssembler *turbo_assembler_, addr_t dst_vmaddr, bool page) {
+  relo_fixup_t *fixup = &ctx->fixups[ctx->fixup_count++];
+  fixup->type = kReloFixupMov64;
+  fixup->page = page;
+  fixup->src_off = (int64_t)(dst_vmaddr - ctx->src_vmaddr);
+  fixup->buffer_off = turbo_assembler_->GetCodeBuffer()->GetBufferSize();
+  fixup->label = nullptr;
+}
+
+typedef void (*relo_insn_handler_t)(relo_ctx_t *ctx, TurboAssembler *turbo_assembler_, arm64_inst_t inst);
+
+#define _ turbo_assembler_->
+
+static void relo_insn_other(relo_ctx_t *, TurboAssembler *turbo_assembler_, arm64_inst_t inst) {
+  _ Emit(inst);
+}
+
+static void relo_insn_b_bl(relo_ctx_t *ctx, TurboAssembler *turbo_assembler_, arm64_inst_t inst) {
+  DEBUG_LOG("%d:relo <b_bl> at %p", ctx->relocated_insn_count++, relo_cur_src_vmaddr(ctx));
+
+  int64_t offset = decode_imm26_offset(inst);
+  addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
+
+  auto dst_label = RelocLabel::withData(dst_vmaddr);
+  _ AppendRelocLabel(dst_label);
+  relo_record_literal_fixup(ctx, dst_label, dst_vmaddr);
+
+  {
+    _ Ldr(TMP_REG_0, dst_label);
+    if ((inst & UnconditionalBranchMask) == BL) {
+      _ blr(TMP_REG_0);
+    } else {
+      _ br(TMP_REG_0);
     }
-#endif
+  }
+}
 
-    arm64_inst_t inst = *(arm64_inst_t *)ctx->buffer_cursor;
-    if (inst_is_b_bl(inst)) {
-      DEBUG_LOG("%d:relo <b_bl> at %p", relocated_insn_count++, relo_cur_src_vmaddr(ctx));
-
-      int64_t offset = decode_imm26_offset(inst);
-      addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
-
-      auto dst_label = RelocLabel::withData(dst_vmaddr);
-      _ AppendRelocLabel(dst_label);
-
-      {
-        _ Ldr(TMP_REG_0, dst_label);
-        if ((inst & UnconditionalBranchMask) == BL) {
-          _ blr(TMP_REG_0);
-        } else {
-          _ br(TMP_REG_0);
-        }
-      }
+static void relo_insn_ldr_literal(relo_ctx_t *ctx, TurboAssembler *turbo_assembler_, arm64_inst_t inst) {
+  DEBUG_LOG("%d:relo <ldr_literal> at %p", ctx->relocated_insn_count++, relo_cur_src_vmaddr(ctx));
 
-    } else if (inst_is_ldr_literal(inst)) {
-      DEBUG_LOG("%d:relo <ldr_literal> at %p", relocated_insn_count++, relo_cur_src_vmaddr(ctx));
+  int64_t offset = decode_imm19_offset(inst);
+  addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
 
-      int64_t offset = decode_imm19_offset(inst);
-      addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
+  int rt = decode_rt(inst);
+  char opc = bits(inst, 30, 31);
 
-      int rt = decode_rt(inst);
-      char opc = bits(inst, 30, 31);
+  {
+    relo_record_mov_fixup(ctx, turbo_assembler_, dst_vmaddr, false);
+    _ Mov(TMP_REG_0, dst_vmaddr);
+    if (opc == 0b00)
+      _ ldr(W(rt), MemOperand(TMP_REG_0, 0));
+    else if (opc == 0b01)
+      _ ldr(X(rt), MemOperand(TMP_REG_0, 0));
+    else {
+      UNIMPLEMENTED();
+    }
+  }
+}
 
-      {
-        _ Mov(TMP_REG_0, dst_vmaddr);
-        if (opc == 0b00)
-          _ ldr(W(rt), MemOperand(TMP_REG_0, 0));
-        else if (opc == 0b01)
-          _ ldr(X(rt), MemOperand(TMP_REG_0, 0));
-        else {
-          UNIMPLEMENTED();
-        }
-      }
-    } else if (inst_is_adr(inst)) {
-      DEBUG_LOG("%d:relo <adr> at %p", relocated_insn_count++, relo_cur_src_vmaddr(ctx));
+static void relo_insn_adr(relo_ctx_t *ctx, TurboAssembler *turbo_assembler_, arm64_inst_t inst) {
+  DEBUG_LOG("%d:relo <adr> at %p", ctx->relocated_insn_count++, relo_cur_src_vmaddr(ctx));
 
-      int64_t offset = decode_immhi_immlo_offset(inst);
-      addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
+  int64_t offset = decode_immhi_immlo_offset(inst);
+  addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
 
-      int rd = decode_rd(inst);
+  int rd = decode_rd(inst);
 
-      {
-        _ Mov(X(rd), dst_vmaddr);
-        ;
-      }
-    } else if (inst_is_adrp(inst)) {
-      DEBUG_LOG("%d:relo <adrp> at %p", relocated_insn_count++, relo_cur_src_vmaddr(ctx));
+  {
+    relo_record_mov_fixup(ctx, turbo_assembler_, dst_vmaddr, false);
+    _ Mov(X(rd), dst_vmaddr);
+    ;
+  }
+}
 
-      int64_t offset = decode_immhi_immlo_zero12_offset(inst);
-      addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
-      dst_vmaddr = arm64_trunc_page(dst_vmaddr);
+static void relo_insn_adrp(relo_ctx_t *ctx, TurboAssembler *turbo_assembler_, arm64_inst_t inst) {
+  DEBUG_LOG("%d:relo <adrp> at %p", ctx->relocated_insn_count++, relo_cur_src_vmaddr(ctx));
 
-      int rd = decode_rd(inst);
+  int64_t offset = decode_immhi_immlo_zero12_offset(inst);
+  addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
+  dst_vmaddr = arm64_trunc_page(dst_vmaddr);
 
-      {
-        _ Mov(X(rd), dst_vmaddr);
-        ;
-      }
-    } else if (inst_is_b_cond(inst)) {
-      DEBUG_LOG("%d:relo <b_cond> at %p", relocated_insn_count++, relo_cur_src_vmaddr(ctx));
+  int rd = decode_rd(inst);
 
-      int64_t offset = decode_imm19_offset(inst);
-      addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
+  {
+    relo_record_mov_fixup(ctx, turbo_assembler_, dst_vmaddr, true);
+    _ Mov(X(rd), dst_vmaddr);
+    ;
+  }
+}
 
-      arm64_inst_t branch_instr = inst;
-      {
-        char cond = bits(inst, 0, 3);
-        cond = cond ^ 1;
-        set_bits(branch_instr, 0, 3, cond);
+// emit the inverted branch over [ldr, br, #label] to the original target
+static void relo_insn_inverted_branch(relo_ctx_t *ctx, TurboAssembler *turbo_assembler_, arm64_inst_t branch_instr,
+                                      addr_t dst_vmaddr) {
+  auto dst_label = RelocLabel::withData(dst_vmaddr);
+  _ AppendRelocLabel(dst_label);
+  relo_record_literal_fixup(ctx, dst_label, dst_vmaddr);
 
-        int64_t offset = 4 * 3;
-        uint32_t imm19 = offset >> 2;
-        set_bits(branch_instr, 5, 23, imm19);
-      }
+  {
+    _ Emit(branch_instr);
+    {
+      _ Ldr(TMP_REG_0, dst_label);
+      _ br(TMP_REG_0);
+    }
+  }
+}
 
-      auto dst_label = RelocLabel::withData(dst_vmaddr);
-      _ AppendRelocLabel(dst_label);
+static void relo_insn_b_cond(relo_ctx_t *ctx, TurboAssembler *turbo_assembler_, arm64_inst_t inst) {
+  DEBUG_LOG("%d:relo <b_cond> at %p", ctx->relocated_insn_count++, relo_cur_src_vmaddr(ctx));
 
-      {
-        _ Emit(branch_instr);
-        {
-          _ Ldr(TMP_REG_0, dst_label);
-          _ br(TMP_REG_0);
-        }
-      }
-    } else if (inst_is_compare_b(inst)) {
-      DEBUG_LOG("%d:relo <compare_b> at %p", relocated_insn_count++, relo_cur_src_vmaddr(ctx));
+  int64_t offset = decode_imm19_offset(inst);
+  addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
 
-      int64_t offset = decode_imm19_offset(inst);
-      addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
+  arm64_inst_t branch_instr = inst;
+  {
+    char cond = bits(inst, 0, 3);
+    cond = cond ^ 1;
+    set_bits(branch_instr, 0, 3, cond);
 
-      arm64_inst_t branch_instr = inst;
-      {
-        char op = bit(inst, 24);
-        op = op ^ 1;
-        set_bit(branch_instr, 24, op);
+    int64_t offset = 4 * 3;
+    uint32_t imm19 = offset >> 2;
+    set_bits(branch_instr, 5, 23, imm19);
+  }
 
-        int64_t offset = 4 * 3;
-        uint32_t imm19 = offset >> 2;
-        set_bits(branch_instr, 5, 23, imm19);
-      }
+  relo_insn_inverted_branch(ctx, turbo_assembler_, branch_instr, dst_vmaddr);
+}
 
-      auto dst_label = RelocLabel::withData(dst_vmaddr);
-      _ AppendRelocLabel(dst_label);
+static void relo_insn_compare_b(relo_ctx_t *ctx, TurboAssembler *turbo_assembler_, arm64_inst_t inst) {
+  DEBUG_LOG("%d:relo <compare_b> at %p", ctx->relocated_insn_count++, relo_cur_src_vmaddr(ctx));
 
-      {
-        _ Emit(branch_instr);
-        {
-          _ Ldr(TMP_REG_0, dst_label);
-          _ br(TMP_REG_0);
-        }
-      }
-    } else if (inst_is_test_b(inst)) {
-      DEBUG_LOG("%d:relo <test_b> at %p", relocated_insn_count++, relo_cur_src_vmaddr(ctx));
+  int64_t offset = decode_imm19_offset(inst);
+  addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
 
-      int64_t offset = decode_imm14_offset(inst);
-      addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
+  arm64_inst_t branch_instr = inst;
+  {
+    char op = bit(inst, 24);
+    op = op ^ 1;
+    set_bit(branch_instr, 24, op);
 
-      arm64_inst_t branch_instr = inst;
-      {
-        char op = bit(inst, 24);
-        op = op ^ 1;
-        set_bit(branch_instr, 24, op);
+    int64_t offset = 4 * 3;
+    uint32_t imm19 = offset >> 2;
+    set_bits(branch_instr, 5, 23, imm19);
+  }
 
-        int64_t offset = 4 * 3;
-        uint32_t imm14 = offset >> 2;
-        set_bits(branch_instr, 5, 18, imm14);
-      }
+  relo_insn_inverted_branch(ctx, turbo_assembler_, branch_instr, dst_vmaddr);
+}
 
-      auto dst_label = RelocLabel::withData(dst_vmaddr);
-      _ AppendRelocLabel(dst_label);
+static void relo_insn_test_b(relo_ctx_t *ctx, TurboAssembler *turbo_assembler_, arm64_inst_t inst) {
+  DEBUG_LOG("%d:relo <test_b> at %p", ctx->relocated_insn_count++, relo_cur_src_vmaddr(ctx));
 
-      {
-        _ Emit(branch_instr);
-        {
-          _ Ldr(TMP_REG_0, dst_label);
-          _ br(TMP_REG_0);
-        }
-      }
+  int64_t offset = decode_imm14_offset(inst);
+  addr_t dst_vmaddr = relo_cur_src_vmaddr(ctx) + offset;
+
+  arm64_inst_t branch_instr = inst;
+  {
+    char op = bit(inst, 24);
+    op = op ^ 1;
+    set_bit(branch_instr, 24, op);
+
+    int64_t offset = 4 * 3;
+    uint32_t imm14 = offset >> 2;
+    set_bits(branch_instr, 5, 18, imm14);
+  }
+
+  relo_insn_inverted_branch(ctx, turbo_assembler_, branch_instr, dst_vmaddr);
+}
+
+#undef _
+
+static const relo_insn_handler_t relo_insn_handlers[kReloInsnKindCount] = {
+    relo_insn_other,  relo_insn_b_bl,   relo_insn_ldr_literal, relo_insn_adr,
+    relo_insn_adrp,   relo_insn_b_cond, relo_insn_compare_b,   relo_insn_test_b,
+};
+
+// ================================================================
+// relocation cache
+
+// relocated code keyed by the prologue bytes and the page offset of the source (adrp depends on it),
+// a hit re-emits the cached bytes with the absolute addresses fixed up for the new source.
+// entries live in process memory, so children forked after a hook (zygote) inherit them
+#define RELO_CACHE_MAX_ENTRY_COUNT 64
+
+typedef struct {
+  uint8_t prologue[RELO_MAX_INSN_COUNT * sizeof(arm64_inst_t)];
+  uint32_t prologue_size;
+  uint32_t src_page_off;
+  bool branch;
+
+  uint32_t origin_size;
+  tinystl::vector<uint8_t> code;
+  tinystl::vector<relo_fixup_t> fixups;
+} relo_cache_entry_t;
+
+static tinystl::vector<relo_cache_entry_t *> relo_cache;
+
+static relo_cache_entry_t *relo_cache_find(relo_ctx_t *ctx, bool branch) {
+  for (auto entry : relo_cache) {
+    if (entry->prologue_size == ctx->buffer_size && entry->src_page_off == (ctx->src_vmaddr & 0xfff) &&
+        entry->branch == branch && memcmp(entry->prologue, ctx->buffer, ctx->buffer_size) == 0)
+      return entry;
+  }
+  return nullptr;
+}
+
+static void relo_cache_add(relo_ctx_t *ctx, bool branch, CodeBufferBase *buffer) {
+  if (relo_cache.size() >= RELO_CACHE_MAX_ENTRY_COUNT || ctx->buffer_size > sizeof(relo_cache_entry_t::prologue))
+    return;
+
+  auto entry = new relo_cache_entry_t;
+  memcpy(entry->prologue, ctx->buffer, ctx->buffer_size);
+  entry->prologue_size = ctx->buffer_size;
+  entry->src_page_off = ctx->src_vmaddr & 0xfff;
+  entry->branch = branch;
+  entry->origin_size = ctx->origin->size;
+  for (uint32_t i = 0; i < buffer->GetBufferSize(); i++) {
+    entry->code.push_back(buffer->GetBuffer()[i]);
+  }
+  for (int i = 0; i < ctx->fixup_count; i++) {
+    entry->fixups.push_back(ctx->fixups[i]);
+    entry->fixups.back().label = nullptr;
+  }
+  relo_cache.push_back(entry);
+}
+
+// @Return: false if no exec memory, the caller relocates without the cache
+static bool relo_cache_emit(relo_ctx_t *ctx, relo_cache_entry_t *entry) {
+  tinystl::vector<uint8_t> code = entry->code;
+  for (auto &fixup : entry->fixups) {
+    uint64_t target = ctx->src_vmaddr + fixup.src_off;
+    if (fixup.page)
+      target = arm64_trunc_page(target);
+
+    uint8_t *cursor = code.data() + fixup.buffer_off;
+    if (fixup.type == kReloFixupLiteral64) {
+      memcpy(cursor, &target, sizeof(uint64_t));
     } else {
-      _ Emit(inst);
+      // movz, movk, movk, movk
+      for (int i = 0; i < 4; i++) {
+        uint32_t inst;
+        memcpy(&inst, cursor + i * 4, sizeof(uint32_t));
+        uint32_t imm16 = (target >> (16 * i)) & 0xffff;
+        set_bits(inst, 5, 20, imm16);
+        memcpy(cursor + i * 4, &inst, sizeof(uint32_t));
+      }
     }
+  }
+
+  auto block = MemoryAllocator::SharedAllocator()->allocateExecBlock(code.size());
+  if (block == nullptr) {
+    ERROR_LOG("[insn relocate] relocation cache hit, allocate exec block failed");
+    return false;
+  }
+  DobbyCodePatch((void *)block->addr, code.data(), code.size());
+  PerfMap::Record(block->addr, code.size(), "relocated", ctx->src_vmaddr);
+
+  ctx->origin->reset(ctx->origin->addr, entry->origin_size);
+  ctx->relocated = block;
+  DEBUG_LOG("[insn relocate] relocation cache hit, %p", ctx->src_vmaddr);
+  return true;
+}
+
+// ---
+
+int relo_relocate(relo_ctx_t *ctx, bool branch) {
+  auto cache_entry = relo_cache_find(ctx, branch);
+  if (cache_entry && relo_cache_emit(ctx, cache_entry))
+    return 0;
+
+  TurboAssembler turbo_assembler_(0);
+
+  auto relocated_buffer = turbo_assembler_.GetCodeBuffer();
+
+  while (ctx->buffer_cursor < ctx->buffer + ctx->buffer_size) {
+    uint32_t orig_off = ctx->buffer_cursor - ctx->buffer;
+    uint32_t relocated_off = relocated_buffer->GetBufferSize();
+    ctx->relocated_offset_map[orig_off / sizeof(arm64_inst_t)] = relocated_off;
+
+#if 0
+    addr_t inst_vmaddr = 0;
+    inst_vmaddr = relo_cur_src_vmaddr(ctx);
+    if (has_relo_label_at(ctx, inst_vmaddr)) {
+      auto *label = relo_label_create_or_get(ctx, inst_vmaddr);
+      label->bind_to(inst_vmaddr);
+    }
+#endif
+
+    arm64_inst_t inst = *(arm64_inst_t *)ctx->buffer_cursor;
+    relo_insn_handlers[relo_decode_table[(uint32_t)inst >> 24]](ctx, &turbo_assembler_, inst);
 
     ctx->buffer_cursor += sizeof(arm64_inst_t);
   }
-#undef _
 
   // update origin
   int new_origin_len = (addr_t)ctx->buffer_cursor - (addr_t)ctx->buffer;
@@ -328,23 +532,99 @@ int relo_relocate(relo_ctx_t *ctx, bool branch) {
 
   // TODO: if last instr is unlink branch, ignore it
   if (branch) {
-    CodeGen codegen(&turbo_assembler_);
-    codegen.LiteralLdrBranch(ctx->origin->addr + ctx->origin->size);
+    // same as CodeGen::LiteralLdrBranch, with the literal recorded as fixup
+    addr_t next_vmaddr = ctx->origin->addr + ctx->origin->size;
+    auto next_label = RelocLabel::withData(next_vmaddr);
+    turbo_assembler_.AppendRelocLabel(next_label);
+    relo_record_literal_fixup(ctx, next_label, next_vmaddr);
+
+    turbo_assembler_.Ldr(TMP_REG_0, next_label);
+    turbo_assembler_.br(TMP_REG_0);
   }
 
   // Bind all labels
   turbo_assembler_.RelocBind();
 
+  for (int i = 0; i < ctx->fixup_count; i++) {
+    if (ctx->fixups[i].label)
+      ctx->fixups[i].buffer_off = ctx->fixups[i].label->pos();
+  }
+
+  relo_cache_add(ctx, branch, relocated_buffer);
+
   // Generate executable code
   {
-    auto code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_);
+    auto code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_, "relocated", ctx->src_vmaddr);
     ctx->relocated = code;
   }
   return 0;
 }
 
+// ---
+
+// linear sweep bound when the function end can't be found
+#define SCAN_MAX_FUNCTION_SIZE 4096
+
+static inline bool inst_is_function_exit(uint32_t instr) {
+  // ret, br, retaa, retab
+  return (instr & 0xfffffc1f) == 0xd65f0000 || (instr & 0xfffffc1f) == 0xd61f0000 || instr == 0xd65f0bff ||
+         instr == 0xd65f0fff;
+}
+
+uint32_t GenScanFunctionBranchTarget(void *buffer, uint32_t patch_size, uint32_t scan_size) {
+  addr_t func = (addr_t)buffer;
+  addr_t max_forward_target = func;
+  uint32_t lowest_target_off = 0;
+
+  if (scan_size > SCAN_MAX_FUNCTION_SIZE)
+    scan_size = SCAN_MAX_FUNCTION_SIZE;
+  scan_size = ALIGN_FLOOR(scan_size, sizeof(arm64_inst_t));
+
+  for (uint32_t off = 0; off < scan_size; off += sizeof(arm64_inst_t)) {
+    addr_t pc = func + off;
+    uint32_t inst = *(uint32_t *)pc;
+
+    addr_t target = 0;
+    bool is_b = false;
+    switch (relo_decode_table[inst >> 24]) {
+    case kReloInsnBBL:
+      target = pc + decode_imm26_offset(inst);
+      is_b = (inst & UnconditionalBranchMask) == B;
+      break;
+    case kReloInsnBCond:
+    case kReloInsnCompareB:
+      target = pc + decode_imm19_offset(inst);
+      break;
+    case kReloInsnTestB:
+      target = pc + decode_imm14_offset(inst);
+      break;
+    case kReloInsnAdr:
+      target = pc + decode_immhi_immlo_offset(inst);
+      break;
+    default:
+      break;
+    }
+
+    if (target > func && target < func + patch_size) {
+      uint32_t target_off = target - func;
+      if (!lowest_target_off || target_off < lowest_target_off)
+        lowest_target_off = target_off;
+    }
+
+    // forward branch keeps the function alive past the next exit
+    if (target > pc && target < func + scan_size && target > max_forward_target)
+      max_forward_target = target;
+
+    // function end: exit instruction that no earlier branch jumps over
+    if ((is_b || inst_is_function_exit(inst)) && pc >= max_forward_target)
+      break;
+  }
+  return lowest_target_off;
+}
+
 void GenRelocateCode(void *buffer, CodeMemBlock *origin, CodeMemBlock *relocated, bool branch) {
-  relo_ctx_t ctx = {0};
+  relo_ctx_t ctx;
+  memset(&ctx, 0, sizeof(relo_ctx_t));
 
   ctx.buffer = ctx.buffer_cursor = (uint8_t *)buffer;
   ctx.buffer_size = origin->size;
@@ -60,7 +60,7 @@ int GenRelocateCodeFixed(void *buffer, CodeMemBlock *origin, CodeMemBlock *reloc
 
   // generate executable code
   {
-    auto code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_);
+    auto code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_, "relocated", (addr_t)origin->addr);
     relocated->reset(code->addr, code->size);
     delete code;
   }
@@ -51,7 +51,8 @@ int GenRelocateSingleX86Insn(addr_t curr_orig_ip, addr_t curr_relo_ip, uint8_t *
   auto x86_insn_encode_begin = [&] { x86_insn_encode_start = code_buffer->GetBufferSize(); };
   auto x86_insn_encode_end = [&] { x86_insn_encoded_len = code_buffer->GetBufferSize() - x86_insn_encode_start; };
 
-  if (insn.primary_opcode >= 0x70 && insn.primary_opcode <= 0x7F) { // jcc rel8
+  bool is_rel_branch = insn.flags & X86_INSN_DECODE_FLAG_BRANCH_RELATIVE;
+  if (is_rel_branch && insn.primary_opcode >= 0x70 && insn.primary_opcode <= 0x7F) { // jcc rel8
     DEBUG_LOG("[x86 relo] %p: jc rel8", buffer_cursor);
 
     int8_t offset = insn.immediate;
@@ -78,6 +79,30 @@ int GenRelocateSingleX86Insn(addr_t curr_orig_ip, addr_t curr_relo_ip, uint8_t *
     codegen_x64_jmp_absolute_addr(code_buffer, orig_dst_ip);
 #endif
 
+  } else if (is_rel_branch && insn.primary_opcode >= 0x80 && insn.primary_opcode <= 0x8F) { // jcc rel32
+    DEBUG_LOG("[x86 relo] %p: jc rel32", buffer_cursor);
+
+    int32_t offset = insn.immediate;
+    addr_t orig_dst_ip = curr_orig_ip + offset;
+#if defined(TARGET_ARCH_IA32)
+    x86_insn_encode_begin();
+    __ Emit8(0x0F);
+    __ Emit8(insn.primary_opcode);
+    emit_rel32_label(code_buffer, x86_insn_encode_start, curr_relo_ip, orig_dst_ip);
+#else
+    // jcc_true stage 1, same as jcc rel8
+    const uint8_t label_jcc_cond_true_stage2 = 2;
+    __ Emit8(0x70 | (insn.primary_opcode & 0x0f));
+    __ Emit8(label_jcc_cond_true_stage2);
+
+    // jcc_false
+    const uint8_t label_cond_false = 6 + 8;
+    __ Emit8(0xEB);
+    __ Emit8(label_cond_false);
+
+    // jcc_true stage 2, jmp to orig dst
+    codegen_x64_jmp_absolute_addr(code_buffer, orig_dst_ip);
+#endif
   } else if (mode == 64 && (insn.flags & X86_INSN_DECODE_FLAG_IP_RELATIVE) &&
              (insn.operands[1].mem.base == RIP)) { // RIP
     DEBUG_LOG("[x86 relo] %p: rip", buffer_cursor);
@@ -104,7 +129,7 @@ int GenRelocateSingleX86Insn(addr_t curr_orig_ip, addr_t curr_relo_ip, uint8_t *
     x86_insn_encode_end();
 
     {
-      auto rip_insn_seq_buffer = CodeBufferBase();
+      CodeBufferBase rip_insn_seq_buffer;
 #define ___ rip_insn_seq_buffer.
 
       auto rip_insn_req_ip = rip_insn_seq_addr;
@@ -126,7 +151,7 @@ int GenRelocateSingleX86Insn(addr_t curr_orig_ip, addr_t curr_relo_ip, uint8_t *
       DobbyCodePatch((void *)rip_insn_seq_addr, rip_insn_seq_buffer.GetBuffer(), rip_insn_seq_buffer.GetBufferSize());
     }
 
-  } else if (insn.primary_opcode == 0xEB) { // jmp rel8
+  } else if (is_rel_branch && insn.primary_opcode == 0xEB) { // jmp rel8
     DEBUG_LOG("[x86 relo] %p: jmp rel8", buffer_cursor);
 
     int8_t offset = insn.immediate;
@@ -140,18 +165,17 @@ int GenRelocateSingleX86Insn(addr_t curr_orig_ip, addr_t curr_relo_ip, uint8_t *
     // jmp *(rip)
     codegen_x64_jmp_absolute_addr(code_buffer, orig_dst_ip);
 #endif
-  } else if (insn.primary_opcode == 0xE8 || insn.primary_opcode == 0xE9) { // call or jmp rel32
+  } else if (is_rel_branch && (insn.primary_opcode == 0xE8 || insn.primary_opcode == 0xE9)) { // call or jmp rel32
     DEBUG_LOG("[x86 relo] %p:jmp or call rel32", buffer_cursor);
 
     int32_t offset = insn.immediate;
     addr_t orig_dst_ip = curr_orig_ip + offset;
 
-    assert(insn.immediate_offset == 1);
-
 #if defined(TARGET_ARCH_IA32)
     x86_insn_encode_begin();
 
-    __ EmitBuffer(buffer_cursor, insn.immediate_offset);
+    // re-encode without the prefixes, a 66 prefixed one only has a rel16
+    __ Emit8(insn.primary_opcode);
     emit_rel32_label(code_buffer, x86_insn_encode_start, curr_relo_ip, orig_dst_ip);
 #else
     __ Emit8(0xFF);
@@ -175,10 +199,10 @@ int GenRelocateSingleX86Insn(addr_t curr_orig_ip, addr_t curr_relo_ip, uint8_t *
       __ Emit64(orig_dst_ip);
     }
 #endif
-  } else if (insn.primary_opcode >= 0xE0 && insn.primary_opcode <= 0xE2) { // LOOPNZ/LOOPZ/LOOP/JECXZ
+  } else if (is_rel_branch && insn.primary_opcode >= 0xE0 && insn.primary_opcode <= 0xE2) { // LOOPNZ/LOOPZ/LOOP/JECXZ
     // LOOP/LOOPcc
     UNIMPLEMENTED();
-  } else if (insn.primary_opcode == 0xE3) {
+  } else if (is_rel_branch && insn.primary_opcode == 0xE3) {
     // JCXZ JCEXZ JCRXZ
     UNIMPLEMENTED();
   } else {
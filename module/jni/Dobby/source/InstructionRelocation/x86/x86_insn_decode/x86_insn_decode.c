@@ -218,6 +218,15 @@ int x86_insn_immediate_type(x86_insn_spec_t *insn) {
   return 0;
 }
 
+int x86_insn_has_relative_branch(x86_insn_spec_t *insn) {
+  int i;
+  for (i = 0; i < sizeof(insn->operands) / sizeof(x86_insn_operand_spec_t); i++) {
+    if (insn->operands[i].code == 'J')
+      return 1;
+  }
+  return 0;
+}
+
 int x86_insn_has_immediate(x86_insn_spec_t *insn) {
   int i;
   for (i = 0; i < sizeof(insn->operands) / sizeof(x86_insn_operand_spec_t); i++) {
@@ -294,7 +303,7 @@ void x86_insn_decode_modrm_sib(x86_insn_reader_t *rd, x86_insn_decode_t *insn, x
     insn->flags |= X86_INSN_DECODE_FLAG_HAS_BASE;
 
     if (mod == 0 && (rm & 7) == 5) {
-      insn->flags = X86_INSN_DECODE_FLAG_IP_RELATIVE;
+      insn->flags |= X86_INSN_DECODE_FLAG_IP_RELATIVE;
       mem_op->mem.base = RIP;
       disp_bits = 32;
     } else if (mod == 0) {
@@ -339,7 +348,7 @@ void x86_insn_decode_modrm_sib(x86_insn_reader_t *rd, x86_insn_decode_t *insn, x
 
       // for 64 bit
       if (effective_address_bits == 64) {
-        if (mem_op->mem.base == RBP || mem_op->mem.base == R13) {
+        if (sib.base == X86_INSN_GP_REG_BP) {
           if (mod == 0) {
             mem_op->mem.base = RNone;
           }
@@ -357,7 +366,7 @@ void x86_insn_decode_modrm_sib(x86_insn_reader_t *rd, x86_insn_decode_t *insn, x
 
       // for 32 bit
       if (effective_address_bits == 32) {
-        if (mem_op->mem.base == RBP) {
+        if (sib.base == X86_INSN_GP_REG_BP) {
           if (mod == 0) {
             mem_op->mem.base = RNone;
           }
@@ -532,7 +541,7 @@ void x86_insn_decode_immediate(x86_insn_reader_t *rd, x86_insn_decode_t *insn, x
   insn->immediate = immediate;
 }
 
-void x86_insn_decode(x86_insn_decode_t *insn, uint8_t *buffer, x86_options_t *conf) {
+void x86_insn_decode_spec(x86_insn_decode_t *insn, uint8_t *buffer, x86_options_t *conf) {
   // init reader
   x86_insn_reader_t rd;
   init_reader(&rd, buffer, buffer + 15);
@@ -553,6 +562,10 @@ void x86_insn_decode(x86_insn_decode_t *insn, uint8_t *buffer, x86_options_t *co
     x86_insn_decode_immediate(&rd, insn, conf);
   }
 
+  if (x86_insn_has_relative_branch(&insn->insn_spec)) {
+    insn->flags |= X86_INSN_DECODE_FLAG_BRANCH_RELATIVE;
+  }
+
 #if 1
   DEBUG_LOG("[x86 insn] %s", insn->insn_spec.name);
 #endif
@@ -561,4 +574,246 @@ void x86_insn_decode(x86_insn_decode_t *insn, uint8_t *buffer, x86_options_t *co
   insn->length = rd.buffer_cursor - rd.buffer;
 }
 
+
+#include "./x86_opcode_attr.c"
+
+static inline uint64_t x86_insn_read_number(const uint8_t *p, uint8_t number_bytes) {
+  uint64_t number = 0;
+  for (int i = number_bytes - 1; i >= 0; i--)
+    number = (number << 8) | p[i];
+  return number;
+}
+
+static x86_insn_prefix_t x86_insn_prefix_of(uint8_t c) {
+  switch (c) {
+  case 0xF0:
+    return INSN_PREFIX_LOCK;
+  case 0xF2:
+    return INSN_PREFIX_REPNE;
+  case 0xF3:
+    return INSN_PREFIX_REPE;
+  case 0x2E:
+    return INSN_PREFIX_CS;
+  case 0x36:
+    return INSN_PREFIX_SS;
+  case 0x3E:
+    return INSN_PREFIX_DS;
+  case 0x26:
+    return INSN_PREFIX_ES;
+  case 0x64:
+    return INSN_PREFIX_FS;
+  case 0x65:
+    return INSN_PREFIX_GS;
+  case 0x66:
+    return INSN_PREFIX_OPERAND_SIZE;
+  case 0x67:
+    return INSN_PREFIX_ADDRESS_SIZE;
+  }
+  return INSN_PREFIX_NONE;
+}
+
+/* Same operand fields as x86_insn_decode_modrm_sib, returns the cursor after the displacement. */
+static const uint8_t *x86_insn_decode_modrm_fast(const uint8_t *p, const uint8_t *start, x86_insn_decode_t *insn,
+                                                 int mode_64, uint8_t address_bits) {
+  x86_insn_modrm_t modrm;
+  modrm.byte = *p++;
+  insn->modrm = modrm;
+
+  uint8_t rm = (uint8_t)((REX_B(insn->rex) << 3) | modrm.rm);
+  insn->operands[0].reg = (uint8_t)((REX_R(insn->rex) << 3) | modrm.reg);
+
+  x86_insn_operand_t *mem_op = &insn->operands[1];
+  if (modrm.mode == 3) {
+    mem_op->reg = rm;
+    return p;
+  }
+
+  insn->flags |= X86_INSN_DECODE_FLAG_IS_ADDRESS;
+
+  uint8_t disp_bytes = 0;
+  if (address_bits == 16) {
+    static const uint8_t base16[8] = {X86_INSN_GP_REG_BX, X86_INSN_GP_REG_BX, X86_INSN_GP_REG_BP, X86_INSN_GP_REG_BP,
+                                      X86_INSN_GP_REG_SI, X86_INSN_GP_REG_DI, X86_INSN_GP_REG_BP, X86_INSN_GP_REG_BX};
+    if (modrm.mode == 0 && modrm.rm == 6) {
+      disp_bytes = 2;
+    } else {
+      mem_op->mem.base = base16[modrm.rm];
+      insn->flags |= X86_INSN_DECODE_FLAG_HAS_BASE;
+      if (modrm.rm < 4) {
+        mem_op->mem.index = X86_INSN_GP_REG_SI + (modrm.rm & 1);
+        insn->flags |= X86_INSN_DECODE_FLAG_HAS_INDEX;
+      }
+      disp_bytes = modrm.mode == 1 ? 1 : modrm.mode == 2 ? 2 : 0;
+    }
+  } else {
+    mem_op->mem.base = rm;
+    insn->flags |= X86_INSN_DECODE_FLAG_HAS_BASE;
+
+    disp_bytes = modrm.mode == 1 ? 1 : modrm.mode == 2 ? 4 : 0;
+    if (modrm.mode == 0 && modrm.rm == 5) {
+      // rip relative in 64-bit mode, absolute disp32 otherwise
+      if (mode_64) {
+        insn->flags |= X86_INSN_DECODE_FLAG_IP_RELATIVE;
+        mem_op->mem.base = RIP;
+      } else {
+        mem_op->mem.base = RNone;
+      }
+      disp_bytes = 4;
+    }
+
+    if (modrm.rm == 4) {
+      x86_insn_sib_t sib;
+      sib.byte = *p++;
+      insn->sib = sib;
+
+      mem_op->mem.base = (uint8_t)(sib.base | (REX_B(insn->rex) << 3));
+      if (sib.index != X86_INSN_GP_REG_SP) {
+        insn->flags |= X86_INSN_DECODE_FLAG_HAS_INDEX;
+        mem_op->mem.index = (uint8_t)(sib.index | (REX_X(insn->rex) << 3));
+        mem_op->mem.scale = (uint8_t)(1 << sib.log2_scale);
+      } else {
+        mem_op->mem.index = RNone;
+        mem_op->mem.scale = 0;
+      }
+
+      // [disp32 + index] without base
+      if (sib.base == X86_INSN_GP_REG_BP) {
+        if (modrm.mode == 0)
+          mem_op->mem.base = RNone;
+        disp_bytes = modrm.mode == 1 ? 1 : 4;
+      }
+    }
+  }
+
+  if (disp_bytes) {
+    insn->displacement_offset = (uint8_t)(p - start);
+    mem_op->mem.disp = (uint32_t)x86_insn_read_number(p, disp_bytes);
+    p += disp_bytes;
+  }
+  return p;
+}
+
+/* Table driven decoder, the opcode attributes give modrm, immediate and branch information in one lookup. */
+void x86_insn_decode(x86_insn_decode_t *insn, uint8_t *buffer, x86_options_t *conf) {
+  const uint8_t *p = buffer;
+  int mode_64 = conf->mode == 64;
+
+  // prefixes, a rex prefix must immediately precede the opcode
+  x86_insn_prefix_t prefix = INSN_PREFIX_NONE;
+  for (;;) {
+    uint8_t c = *p;
+    if (mode_64 && (c & 0xf0) == 0x40) {
+      insn->rex = c;
+      if (REX_W(c))
+        insn->flags |= X86_INSN_DECODE_FLAG_OPERAND_SIZE_64;
+      p++;
+      break;
+    }
+    if (!(x86_opcode_attr_one_byte[c] & X86_OPC_PREFIX))
+      break;
+    prefix |= x86_insn_prefix_of(c);
+    p++;
+  }
+  insn->prefix = prefix;
+
+  // opcode
+  uint8_t opcode = *p++;
+  uint16_t attr = x86_opcode_attr_one_byte[opcode];
+  if (opcode == 0x0f) {
+    opcode = *p++;
+    attr = x86_opcode_attr_two_byte[opcode];
+    if (attr & X86_OPC_THREE_BYTE) {
+      opcode = *p++;
+      attr &= ~X86_OPC_THREE_BYTE;
+    }
+  } else if ((attr & X86_OPC_VEX) && (mode_64 || (*p & 0xc0) == 0xc0)) {
+    // vex, rex bits are stored inverted
+    uint8_t map = 1;
+    uint8_t rxb = *p;
+    if (opcode == 0xc4) {
+      map = *p & 0x1f;
+      if (*(p + 1) & 0x80)
+        insn->flags |= X86_INSN_DECODE_FLAG_OPERAND_SIZE_64;
+      p += 2;
+    } else {
+      rxb |= 0x60;
+      p += 1;
+    }
+    insn->rex = (uint8_t)(0x40 | ((~rxb >> 5) & 0x7));
+    opcode = *p++;
+    attr = map == 1 ? x86_opcode_attr_two_byte[opcode] : map == 3 ? (X86_OPC_MODRM | (X86_OPC_IMM_B << X86_OPC_IMM_SHIFT)) : X86_OPC_MODRM;
+  }
+  insn->primary_opcode = opcode;
+
+  if (attr & X86_OPC_INVALID_64 && mode_64) {
+    ERROR_LOG("[x86 insn] invalid opcode 0x%x in 64-bit mode", opcode);
+  }
+  if (attr & X86_OPC_REL) {
+    insn->flags |= X86_INSN_DECODE_FLAG_BRANCH_RELATIVE;
+  }
+
+  uint8_t address_bits;
+  if (mode_64)
+    address_bits = (prefix & INSN_PREFIX_ADDRESS_SIZE) ? 32 : 64;
+  else
+    address_bits = (prefix & INSN_PREFIX_ADDRESS_SIZE) ? 16 : 32;
+
+  if (attr & X86_OPC_MODRM) {
+    p = x86_insn_decode_modrm_fast(p, buffer, insn, mode_64, address_bits);
+  }
+
+  uint8_t imm_type = X86_OPC_IMM(attr);
+  if (imm_type != X86_OPC_IMM_NONE) {
+    uint8_t operand_bits = (prefix & INSN_PREFIX_OPERAND_SIZE) ? 16 : 32;
+    if (insn->flags & X86_INSN_DECODE_FLAG_OPERAND_SIZE_64)
+      operand_bits = 64;
+    if (mode_64 && (attr & X86_OPC_DEFAULT_64))
+      operand_bits = 64;
+
+    uint8_t imm_bytes = 0, imm_extra_bytes = 0;
+    switch (imm_type) {
+    case X86_OPC_IMM_B:
+      imm_bytes = 1;
+      break;
+    case X86_OPC_IMM_W:
+      imm_bytes = 2;
+      break;
+    case X86_OPC_IMM_Z:
+      imm_bytes = operand_bits == 16 ? 2 : 4;
+      break;
+    case X86_OPC_IMM_V:
+      imm_bytes = operand_bits / 8;
+      break;
+    case X86_OPC_IMM_W_B:
+      imm_bytes = 2;
+      imm_extra_bytes = 1;
+      break;
+    case X86_OPC_IMM_MOFFS:
+      imm_bytes = address_bits / 8;
+      break;
+    case X86_OPC_IMM_GROUP_3:
+      if (insn->modrm.reg < 2)
+        imm_bytes = (opcode & 1) ? (operand_bits == 16 ? 2 : 4) : 1;
+      break;
+    case X86_OPC_IMM_AP:
+      imm_bytes = operand_bits == 16 ? 2 : 4;
+      imm_extra_bytes = 2;
+      break;
+    }
+
+    if (imm_bytes) {
+      insn->immediate_offset = (uint8_t)(p - buffer);
+      insn->immediate = (int64_t)x86_insn_read_number(p, imm_bytes);
+      if (attr & X86_OPC_REL) {
+        // branch displacements are signed, the rel16 of an operand size prefixed one too
+        int shift = 64 - imm_bytes * 8;
+        insn->immediate = (int64_t)((uint64_t)insn->immediate << shift) >> shift;
+      }
+      p += imm_bytes + imm_extra_bytes;
+    }
+  }
+
+  insn->length = (uint32_t)(p - buffer);
+}
+
 #endif
\ No newline at end of file
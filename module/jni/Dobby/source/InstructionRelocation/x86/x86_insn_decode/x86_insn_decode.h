@@ -18,6 +18,9 @@ typedef enum {
   X86_INSN_DECODE_FLAG_IP_RELATIVE = 1 << 3,
 
   X86_INSN_DECODE_FLAG_OPERAND_SIZE_64 = 1 << 4,
+
+  // immediate is a branch displacement relative to the next insn
+  X86_INSN_DECODE_FLAG_BRANCH_RELATIVE = 1 << 5,
 } x86_insn_decode_flag_t;
 
 typedef enum {
@@ -191,8 +194,13 @@ typedef struct x86_options_t {
 extern "C" {
 #endif
 
+// table driven decoder, fills everything but insn_spec
 void x86_insn_decode(x86_insn_decode_t *insn, uint8_t *buffer, x86_options_t *conf);
 
+// reference decoder walking the operand specs, slower, also fills insn_spec
+// the specs do not describe the operands of the modrm reg groups 3, 5, 6, 7 and the x87 / vex opcodes
+void x86_insn_decode_spec(x86_insn_decode_t *insn, uint8_t *buffer, x86_options_t *conf);
+
 #ifdef __cplusplus
 }
 #endif
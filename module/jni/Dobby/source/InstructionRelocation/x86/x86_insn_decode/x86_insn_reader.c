@@ -60,7 +60,7 @@ static uint64_t read_qword(x86_insn_reader_t *rd) {
   DEBUG_LOG("[x86 insn reader] %p - 8", rd->buffer_cursor);
 
   uint64_t *p = (uint64_t *)rd->buffer_cursor;
-  rd->buffer_cursor += 4;
+  rd->buffer_cursor += 8;
   return p[0];
 }
 
@@ -0,0 +1,110 @@
+/* Precomputed per-opcode attributes for the table driven length decoder.
+ * One entry per opcode of the one-byte map and the two-byte (0F) map.
+ */
+
+#define X86_OPC_MODRM (1 << 0)
+#define X86_OPC_IMM_SHIFT 1
+#define X86_OPC_IMM_MASK (0xf << X86_OPC_IMM_SHIFT)
+#define X86_OPC_IMM(f) (((f)&X86_OPC_IMM_MASK) >> X86_OPC_IMM_SHIFT)
+/* immediate is a branch displacement relative to the next instruction */
+#define X86_OPC_REL (1 << 5)
+#define X86_OPC_DEFAULT_64 (1 << 6)
+#define X86_OPC_INVALID_64 (1 << 7)
+#define X86_OPC_PREFIX (1 << 8)
+/* 0F 38 and 0F 3A escape to the three-byte maps */
+#define X86_OPC_THREE_BYTE (1 << 9)
+/* C4 / C5, vex prefix in 64-bit mode, or in 32-bit mode with modrm.mod == 3 */
+#define X86_OPC_VEX (1 << 10)
+
+enum {
+  X86_OPC_IMM_NONE = 0,
+  X86_OPC_IMM_B,
+  X86_OPC_IMM_W,
+  /* 16 or 32 bits by operand size */
+  X86_OPC_IMM_Z,
+  /* 16, 32 or 64 bits by operand size */
+  X86_OPC_IMM_V,
+  /* enter: iw, ib */
+  X86_OPC_IMM_W_B,
+  /* moffs: address size */
+  X86_OPC_IMM_MOFFS,
+  /* F6 / F7: ib / iz only for test, modrm.reg 0 and 1 */
+  X86_OPC_IMM_GROUP_3,
+  /* far pointer: iz and a 16-bit selector */
+  X86_OPC_IMM_AP,
+};
+
+#define M X86_OPC_MODRM
+#define Ib (X86_OPC_IMM_B << X86_OPC_IMM_SHIFT)
+#define Iw (X86_OPC_IMM_W << X86_OPC_IMM_SHIFT)
+#define Iz (X86_OPC_IMM_Z << X86_OPC_IMM_SHIFT)
+#define Iv (X86_OPC_IMM_V << X86_OPC_IMM_SHIFT)
+#define IwIb (X86_OPC_IMM_W_B << X86_OPC_IMM_SHIFT)
+#define Ob (X86_OPC_IMM_MOFFS << X86_OPC_IMM_SHIFT)
+#define G3 (X86_OPC_IMM_GROUP_3 << X86_OPC_IMM_SHIFT)
+#define Ap (X86_OPC_IMM_AP << X86_OPC_IMM_SHIFT)
+#define Jb (Ib | X86_OPC_REL)
+#define Jz (Iz | X86_OPC_REL)
+#define D64 X86_OPC_DEFAULT_64
+#define I64 X86_OPC_INVALID_64
+#define P X86_OPC_PREFIX
+#define T3 X86_OPC_THREE_BYTE
+#define VX X86_OPC_VEX
+
+// clang-format off
+static const uint16_t x86_opcode_attr_one_byte[256] = {
+    /* 0x00 */ M, M, M, M, Ib, Iz, I64, I64, M, M, M, M, Ib, Iz, I64, 0,
+    /* 0x10 */ M, M, M, M, Ib, Iz, I64, I64, M, M, M, M, Ib, Iz, I64, I64,
+    /* 0x20 */ M, M, M, M, Ib, Iz, P, I64, M, M, M, M, Ib, Iz, P, I64,
+    /* 0x30 */ M, M, M, M, Ib, Iz, P, I64, M, M, M, M, Ib, Iz, P, I64,
+    /* 0x40 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0x50 */ D64, D64, D64, D64, D64, D64, D64, D64, D64, D64, D64, D64, D64, D64, D64, D64,
+    /* 0x60 */ I64, I64, M | I64, M, P, P, P, P, Iz | D64, M | Iz, Ib | D64, M | Ib, 0, 0, 0, 0,
+    /* 0x70 */ Jb, Jb, Jb, Jb, Jb, Jb, Jb, Jb, Jb, Jb, Jb, Jb, Jb, Jb, Jb, Jb,
+    /* 0x80 */ M | Ib, M | Iz, M | Ib | I64, M | Ib, M, M, M, M, M, M, M, M, M, M, M, M | D64,
+    /* 0x90 */ 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, Ap | I64, 0, D64, D64, 0, 0,
+    /* 0xa0 */ Ob, Ob, Ob, Ob, 0, 0, 0, 0, Ib, Iz, 0, 0, 0, 0, 0, 0,
+    /* 0xb0 */ Ib, Ib, Ib, Ib, Ib, Ib, Ib, Ib, Iv, Iv, Iv, Iv, Iv, Iv, Iv, Iv,
+    /* 0xc0 */ M | Ib, M | Ib, Iw, 0, M | VX, M | VX, M | Ib, M | Iz, IwIb, D64, Iw, 0, 0, Ib, I64, 0,
+    /* 0xd0 */ M, M, M, M, Ib | I64, Ib | I64, I64, 0, M, M, M, M, M, M, M, M,
+    /* 0xe0 */ Jb, Jb, Jb, Jb, Ib, Ib, Ib, Ib, Jz | D64, Jz | D64, Ap | I64, Jb, 0, 0, 0, 0,
+    /* 0xf0 */ P, 0, P, P, 0, 0, M | G3, M | G3, 0, 0, 0, 0, 0, 0, M, M,
+};
+
+static const uint16_t x86_opcode_attr_two_byte[256] = {
+    /* 0x00 */ M, M, M, M, 0, 0, 0, 0, 0, 0, 0, 0, 0, M, 0, M | Ib,
+    /* 0x10 */ M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    /* 0x20 */ M, M, M, M, 0, 0, 0, 0, M, M, M, M, M, M, M, M,
+    /* 0x30 */ 0, 0, 0, 0, 0, 0, 0, 0, M | T3, 0, M | Ib | T3, 0, 0, 0, 0, 0,
+    /* 0x40 */ M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    /* 0x50 */ M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    /* 0x60 */ M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    /* 0x70 */ M | Ib, M | Ib, M | Ib, M | Ib, M, M, M, 0, M, M, 0, 0, M, M, M, M,
+    /* 0x80 */ Jz | D64, Jz | D64, Jz | D64, Jz | D64, Jz | D64, Jz | D64, Jz | D64, Jz | D64,
+               Jz | D64, Jz | D64, Jz | D64, Jz | D64, Jz | D64, Jz | D64, Jz | D64, Jz | D64,
+    /* 0x90 */ M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    /* 0xa0 */ D64, D64, 0, M, M | Ib, M, 0, 0, D64, D64, 0, M, M | Ib, M, M, M,
+    /* 0xb0 */ M, M, M, M, M, M, M, M, M, M, M | Ib, M, M, M, M, M,
+    /* 0xc0 */ M, M, M | Ib, M, M | Ib, M | Ib, M | Ib, M, 0, 0, 0, 0, 0, 0, 0, 0,
+    /* 0xd0 */ M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    /* 0xe0 */ M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+    /* 0xf0 */ M, M, M, M, M, M, M, M, M, M, M, M, M, M, M, M,
+};
+// clang-format on
+
+#undef M
+#undef Ib
+#undef Iw
+#undef Iz
+#undef Iv
+#undef IwIb
+#undef Ob
+#undef G3
+#undef Ap
+#undef Jb
+#undef Jz
+#undef D64
+#undef I64
+#undef P
+#undef T3
+#undef VX
@@ -14,5 +14,8 @@ InterceptEntry::InterceptEntry(InterceptEntryType type, addr_t address) {
 #endif
 
   this->patched_addr = address;
+  this->patched_size = 0;
+  this->trampoline_kind = kDobbyTrampolineNone;
+  this->committed = false;
   this->id = Interceptor::SharedInstance()->count();
 }
\ No newline at end of file
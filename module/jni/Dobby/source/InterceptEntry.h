@@ -26,5 +26,10 @@ typedef struct InterceptEntry {
 
   bool thumb_mode;
 
+  DobbyTrampolineKind trampoline_kind;
+
+  // the trampoline has been patched over the origin instructions
+  bool committed;
+
   InterceptEntry(InterceptEntryType type, addr_t address);
 } InterceptEntry;
\ No newline at end of file
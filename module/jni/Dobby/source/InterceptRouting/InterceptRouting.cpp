@@ -2,6 +2,11 @@
 
 #include "InterceptRouting/InterceptRouting.h"
 #include "InterceptRouting/RoutingPlugin/RoutingPlugin.h"
+#include "PlatformUtil/ProcessRuntimeUtility.h"
+#if defined(TARGET_ARCH_ARM64) && defined(NEAR_BRANCH_ENABLED)
+#include "InterceptRouting/RoutingPlugin/NearBranchTrampoline/NearBranchTrampoline.h"
+#include "MemoryAllocator/NearVeneerPool.h"
+#endif
 
 using namespace zz;
 
@@ -13,6 +18,12 @@ void log_hex_format(uint8_t *buffer, uint32_t buffer_size) {
   DEBUG_LOG("%s", output);
 };
 
+InterceptRouting::~InterceptRouting() {
+  ReleaseNearVeneer();
+  delete origin_;
+  delete relocated_;
+}
+
 void InterceptRouting::Prepare() {
 }
 
@@ -51,31 +62,106 @@ bool InterceptRouting::GenerateRelocatedCode() {
   return true;
 }
 
+static bool function_scan_enabled = false;
+
+PUBLIC void dobby_enable_function_scan() {
+  function_scan_enabled = true;
+}
+
+PUBLIC void dobby_disable_function_scan() {
+  function_scan_enabled = false;
+}
+
+#if defined(TARGET_ARCH_ARM64)
+// bytes readable from address up to the end of its mapping
+static uint32_t function_scan_size(addr_t address) {
+  auto &regions = ProcessRuntimeUtility::GetProcessMemoryLayout();
+  for (auto &region : regions) {
+    if (address >= region.start && address < region.end)
+      return region.end - address > UINT32_MAX ? UINT32_MAX : (uint32_t)(region.end - address);
+  }
+  return 0;
+}
+#endif
+
+// the trampoline must not overwrite an instruction that the function branches back to
+bool InterceptRouting::CheckTrampolineBuffer() {
+#if defined(TARGET_ARCH_ARM64)
+  if (!function_scan_enabled)
+    return true;
+
+  uint32_t tramp_size = GetTrampolineBuffer()->GetBufferSize();
+  uint32_t scan_size = function_scan_size(entry_->patched_addr);
+  uint32_t target_off = GenScanFunctionBranchTarget((void *)entry_->patched_addr, tramp_size, scan_size);
+  if (target_off) {
+    ERROR_LOG("[intercept routing] %p: branch target at +%d inside the %d bytes trampoline", entry_->patched_addr,
+              target_off, tramp_size);
+    return false;
+  }
+#endif
+  return true;
+}
+
 bool InterceptRouting::GenerateTrampolineBuffer(addr_t src, addr_t dst) {
+  auto plugin = static_cast<RoutingPluginInterface *>(RoutingPluginManager::near_branch_trampoline);
+#if defined(TARGET_ARCH_ARM64) && defined(NEAR_BRANCH_ENABLED)
+  // always try a single b first unless disabled, fewer prologue instructions to relocate
+  static NearBranchTrampolinePlugin default_near_branch_trampoline;
+  if (!plugin && !RoutingPluginManager::near_branch_trampoline_disabled)
+    plugin = &default_near_branch_trampoline;
+#endif
+
   // if near branch trampoline plugin enabled
-  if (RoutingPluginManager::near_branch_trampoline) {
-    auto plugin = static_cast<RoutingPluginInterface *>(RoutingPluginManager::near_branch_trampoline);
+  if (plugin) {
     if (plugin->GenerateTrampolineBuffer(this, src, dst) == false) {
       DEBUG_LOG("Failed enable near branch trampoline plugin");
+    } else if (entry_->trampoline_kind == kDobbyTrampolineNone) {
+      entry_->trampoline_kind = kDobbyTrampolineNearBranch;
     }
   }
 
+  // the near trampoline is the shortest, fall back to the absolute one only if it is safe
+  if (GetTrampolineBuffer() && !CheckTrampolineBuffer()) {
+    SetTrampolineBuffer(nullptr);
+    ReleaseNearVeneer();
+    entry_->trampoline_kind = kDobbyTrampolineNone;
+    return false;
+  }
+
   if (GetTrampolineBuffer() == nullptr) {
-    auto tramp_buffer = GenerateNormalTrampolineBuffer(src, dst);
-    SetTrampolineBuffer(tramp_buffer);
+    if (!GenerateNormalTrampolineBuffer(src, dst, &trampoline_buffer_))
+      return false;
+    entry_->trampoline_kind = kDobbyTrampolineAbsolute;
+
+    if (!CheckTrampolineBuffer()) {
+      SetTrampolineBuffer(nullptr);
+      entry_->trampoline_kind = kDobbyTrampolineNone;
+      return false;
+    }
   }
   return true;
 }
 
+void InterceptRouting::ReleaseNearVeneer() {
+#if defined(TARGET_ARCH_ARM64) && defined(NEAR_BRANCH_ENABLED)
+  if (near_veneer_)
+    NearVeneerPool::SharedPool()->releaseVeneer(near_veneer_);
+#endif
+  near_veneer_ = 0;
+}
+
 // active routing, patch origin instructions as trampoline
 void InterceptRouting::Active() {
-  auto ret = DobbyCodePatch((void *)entry_->patched_addr, trampoline_buffer_->GetBuffer(),
-                            trampoline_buffer_->GetBufferSize());
+  auto ret = DobbyCodePatch((void *)entry_->patched_addr, trampoline_buffer_.GetBuffer(),
+                            trampoline_buffer_.GetBufferSize());
   if (ret == -1) {
     ERROR_LOG("[intercept routing] active failed");
     return;
   }
-  DEBUG_LOG("[intercept routing] active");
+  entry_->patched_size = trampoline_buffer_.GetBufferSize();
+  entry_->committed = true;
+  DEBUG_LOG("[intercept routing] active, trampoline kind: %d, size: %d", entry_->trampoline_kind,
+            entry_->patched_size);
 }
 
 void InterceptRouting::Commit() {
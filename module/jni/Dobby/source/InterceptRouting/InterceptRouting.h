@@ -14,10 +14,12 @@ public:
     relocated_ = nullptr;
 
     trampoline_ = nullptr;
-    trampoline_buffer_ = nullptr;
     trampoline_target_ = 0;
+    near_veneer_ = 0;
   }
 
+  virtual ~InterceptRouting();
+
   virtual void DispatchRouting() = 0;
 
   virtual void Prepare();
@@ -28,12 +30,17 @@ public:
 
   InterceptEntry *GetInterceptEntry();
 
+  // copy buffer into the inline trampoline buffer, nullptr clears it
   void SetTrampolineBuffer(CodeBufferBase *buffer) {
-    trampoline_buffer_ = buffer;
+    if (buffer)
+      trampoline_buffer_.CopyFrom(buffer);
+    else
+      trampoline_buffer_.Reset();
   }
 
+  // nullptr until a trampoline is generated
   CodeBufferBase *GetTrampolineBuffer() {
-    return trampoline_buffer_;
+    return trampoline_buffer_.GetBufferSize() ? &trampoline_buffer_ : nullptr;
   }
 
   void SetTrampolineTarget(addr_t address) {
@@ -44,11 +51,20 @@ public:
     return trampoline_target_;
   }
 
+  // near veneer the trampoline branches through, released when the trampoline is dropped
+  void SetNearVeneer(addr_t veneer) {
+    near_veneer_ = veneer;
+  }
+
+  void ReleaseNearVeneer();
+
 protected:
   bool GenerateRelocatedCode();
 
   bool GenerateTrampolineBuffer(addr_t src, addr_t dst);
 
+  bool CheckTrampolineBuffer();
+
 protected:
   InterceptEntry *entry_;
 
@@ -56,7 +72,9 @@ protected:
   CodeMemBlock *relocated_;
 
   CodeMemBlock *trampoline_;
-  // trampoline buffer before active
-  CodeBufferBase *trampoline_buffer_;
+  // trampoline buffer before active, the trampoline fits in its inline storage
+  CodeBufferBase trampoline_buffer_;
   addr_t trampoline_target_;
+
+  addr_t near_veneer_;
 };
@@ -3,7 +3,7 @@
 #include "Interceptor.h"
 #include "InterceptRouting/Routing/FunctionInlineHook/FunctionInlineHookRouting.h"
 
-PUBLIC int DobbyHook(void *address, dobby_dummy_func_t replace_func, dobby_dummy_func_t *origin_func) {
+PUBLIC int DobbyPrepare(void *address, dobby_dummy_func_t replace_func, dobby_dummy_func_t *origin_func) {
   if (!address) {
     ERROR_LOG("function address is 0x0");
     return -1;
@@ -21,13 +21,26 @@ PUBLIC int DobbyHook(void *address, dobby_dummy_func_t replace_func, dobby_dummy
   }
 #endif
 
-  DEBUG_LOG("----- [DobbyHook:%p] -----", address);
+  DEBUG_LOG("----- [DobbyPrepare:%p] -----", address);
 
-  // check if already register
+  // check if already register, another hook chains in front of the current replace_func
   auto entry = Interceptor::SharedInstance()->find((addr_t)address);
   if (entry) {
-    ERROR_LOG("%p already been hooked.", address);
-    return -1;
+    if (entry->type != kFunctionInlineHook) {
+      ERROR_LOG("%p already been instrumented.", address);
+      return -1;
+    }
+    auto routing = static_cast<FunctionInlineHookRouting *>(entry->routing);
+    dobby_dummy_func_t chained_origin_func = nullptr;
+    if (!routing->ChainReplaceCall(replace_func, &chained_origin_func))
+      return -1;
+    if (origin_func) {
+      *origin_func = chained_origin_func;
+#if defined(__APPLE__) && defined(__arm64__)
+      *origin_func = pac_sign(*origin_func);
+#endif
+    }
+    return 0;
   }
 
   entry = new InterceptEntry(kFunctionInlineHook, (addr_t)address);
@@ -35,6 +48,12 @@ PUBLIC int DobbyHook(void *address, dobby_dummy_func_t replace_func, dobby_dummy
   auto *routing = new FunctionInlineHookRouting(entry, replace_func);
   routing->Prepare();
   routing->DispatchRouting();
+  if (routing->GetTrampolineBuffer() == nullptr) {
+    ERROR_LOG("%p no safe trampoline.", address);
+    delete routing;
+    delete entry;
+    return -1;
+  }
 
   // set origin func entry with as relocated instructions
   if (origin_func) {
@@ -44,9 +63,15 @@ PUBLIC int DobbyHook(void *address, dobby_dummy_func_t replace_func, dobby_dummy
 #endif
   }
 
-  routing->Commit();
-
   Interceptor::SharedInstance()->add(entry);
 
   return 0;
 }
+
+PUBLIC int DobbyHook(void *address, dobby_dummy_func_t replace_func, dobby_dummy_func_t *origin_func) {
+  int ret = DobbyPrepare(address, replace_func, origin_func);
+  if (ret != 0)
+    return ret;
+
+  return DobbyCommit(address);
+}
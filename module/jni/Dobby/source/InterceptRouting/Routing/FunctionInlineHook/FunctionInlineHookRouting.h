@@ -6,17 +6,71 @@
 
 #include "TrampolineBridge/ClosureTrampolineBridge/ClosureTrampoline.h"
 
+#include "InterceptRouting/Routing/FunctionInlineHook/hook_stats_handler.h"
+
+// one hook of the chain at a patch site
+typedef struct {
+  dobby_dummy_func_t replace_func;
+
+  // where the origin of the hook jumps, the replace_func of the hook below or the relocated prologue
+  addr_t next_hop;
+
+  // origin handed to the hook, it jumps through next_hop so hooks below can be removed. The first hook of a site
+  // gets the relocated prologue instead, nothing is ever chained below it
+  void *origin_bridge;
+} HookChainLink;
+
+// immutable once published, chaining or removing a hook publishes a copy
+typedef struct {
+  uint32_t count;
+  // latest hook first
+  HookChainLink *links[1];
+} HookChainArray;
+
 class FunctionInlineHookRouting : public InterceptRouting {
 public:
-  FunctionInlineHookRouting(InterceptEntry *entry, dobby_dummy_func_t replace_func) : InterceptRouting(entry) {
-    this->replace_func = replace_func;
-  }
+  FunctionInlineHookRouting(InterceptEntry *entry, dobby_dummy_func_t replace_func);
+
+  ~FunctionInlineHookRouting();
 
   void DispatchRouting() override;
 
+  // chain replace_func in front of the latest hook, which it calls as its origin. The trampoline stays, calls reach
+  // replace_func once head_ is stored
+  bool ChainReplaceCall(dobby_dummy_func_t replace_func, dobby_dummy_func_t *origin_func);
+
+  // unlink the hook of replace_func, calls already in it still reach the hooks below
+  // @Return: false if it isn't chained or is the last hook, which only restoring the patch site removes
+  bool RemoveReplaceCall(dobby_dummy_func_t replace_func);
+
+  const HookChainArray *GetChain() {
+    return __atomic_load_n(&chain_, __ATOMIC_ACQUIRE);
+  }
+
+  dobby_dummy_func_t GetReplaceCall() {
+    return (dobby_dummy_func_t)__atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+  }
+
 private:
   void BuildRouting();
 
+public:
+  // call statistics, nullptr unless the hook was prepared with hook stats enabled
+  HookStats *stats;
+
+  // return address installed by the stats bridge
+  void *stats_epilogue_bridge;
+
 private:
-  dobby_dummy_func_t replace_func;
+  void PublishChain(HookChainLink *link, int remove_index);
+
+private:
+  HookChainArray *chain_;
+
+  // replace_func of the latest hook, the trampoline branches to the head bridge jumping through it
+  addr_t head_;
+  void *head_bridge_;
+
+  // with hook stats, the trampoline branches to the stats bridge instead, which dispatches to head_
+  void *stats_prologue_bridge_;
 };
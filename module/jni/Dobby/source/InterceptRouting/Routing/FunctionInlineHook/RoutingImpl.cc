@@ -1,8 +1,56 @@
 #include "dobby/dobby_internal.h"
 #include "InterceptRouting/Routing/FunctionInlineHook/FunctionInlineHookRouting.h"
 
+static void *create_forward_bridge(addr_t *next_hop) {
+  auto bridge = ClosureTrampoline::CreateForwardBridge(next_hop);
+  return bridge ? bridge->address : nullptr;
+}
+
+FunctionInlineHookRouting::FunctionInlineHookRouting(InterceptEntry *entry, dobby_dummy_func_t replace_func)
+    : InterceptRouting(entry) {
+  this->stats = nullptr;
+  this->stats_epilogue_bridge = nullptr;
+  this->stats_prologue_bridge_ = nullptr;
+  this->head_bridge_ = nullptr;
+  this->head_ = (addr_t)replace_func;
+  this->chain_ = nullptr;
+
+  // the first hook calls the relocated prologue directly, its next hop is written after relocation
+  auto link = new HookChainLink;
+  link->replace_func = replace_func;
+  link->next_hop = 0;
+  link->origin_bridge = nullptr;
+  PublishChain(link, -1);
+}
+
+// only a routing which failed to prepare is deleted, no call ever reached its chain
+FunctionInlineHookRouting::~FunctionInlineHookRouting() {
+  for (uint32_t i = 0; i < chain_->count; i++)
+    delete chain_->links[i];
+  free(chain_);
+}
+
+void FunctionInlineHookRouting::PublishChain(HookChainLink *link, int remove_index) {
+  auto prev = chain_;
+  uint32_t count = (prev ? prev->count : 0) + (link ? 1 : 0) - (remove_index != -1 ? 1 : 0);
+  auto chain = (HookChainArray *)malloc(sizeof(HookChainArray) + (count - 1) * sizeof(HookChainLink *));
+  chain->count = 0;
+  if (link)
+    chain->links[chain->count++] = link;
+  for (uint32_t i = 0; prev && i < prev->count; i++) {
+    if ((int)i != remove_index)
+      chain->links[chain->count++] = prev->links[i];
+  }
+
+  // a reader may still walk the previous array, it is never freed
+  __atomic_store_n(&chain_, chain, __ATOMIC_RELEASE);
+}
+
 void FunctionInlineHookRouting::BuildRouting() {
-  SetTrampolineTarget((addr_t)replace_func);
+  if (stats)
+    SetTrampolineTarget((addr_t)stats_prologue_bridge_);
+  else
+    SetTrampolineTarget((addr_t)head_bridge_);
 
   // generate trampoline buffer, run before GenerateRelocatedCode
   addr_t from = entry_->patched_addr;
@@ -15,8 +63,70 @@ void FunctionInlineHookRouting::BuildRouting() {
 }
 
 void FunctionInlineHookRouting::DispatchRouting() {
+  if (hook_stats_enabled()) {
+    stats = hook_stats_create();
+    void *prologue_handler = (void *)hook_stats_dispatch;
+    void *epilogue_handler = (void *)hook_stats_leave_dispatch;
+#if defined(__APPLE__) && defined(__arm64__)
+    prologue_handler = pac_strip(prologue_handler);
+    epilogue_handler = pac_strip(epilogue_handler);
+#endif
+    stats_prologue_bridge_ = ClosureTrampoline::CreateClosureTrampoline(entry_, prologue_handler)->address;
+    stats_epilogue_bridge = ClosureTrampoline::CreateClosureTrampoline(entry_, epilogue_handler)->address;
+    DEBUG_LOG("[hook stats] stats bridge: %p, epilogue bridge: %p", stats_prologue_bridge_, stats_epilogue_bridge);
+  } else {
+    // chained hooks only store head_, the trampoline is never rebuilt
+    head_bridge_ = create_forward_bridge(&head_);
+    if (head_bridge_ == nullptr)
+      return;
+  }
+
   BuildRouting();
+  if (GetTrampolineBuffer() == nullptr)
+    return;
 
   // generate relocated code which size == trampoline size
-  GenerateRelocatedCode();
+  if (!GenerateRelocatedCode())
+    return;
+
+  chain_->links[0]->next_hop = entry_->relocated_addr;
+}
+
+bool FunctionInlineHookRouting::ChainReplaceCall(dobby_dummy_func_t replace_func, dobby_dummy_func_t *origin_func) {
+  auto link = new HookChainLink;
+  link->replace_func = replace_func;
+  link->next_hop = head_;
+  link->origin_bridge = create_forward_bridge(&link->next_hop);
+  if (link->origin_bridge == nullptr) {
+    ERROR_LOG("%p can't chain %p, no origin bridge.", entry_->patched_addr, replace_func);
+    delete link;
+    return false;
+  }
+  PublishChain(link, -1);
+
+  // the calls taking the new head see its next hop
+  __atomic_store_n(&head_, (addr_t)replace_func, __ATOMIC_RELEASE);
+
+  *origin_func = (dobby_dummy_func_t)link->origin_bridge;
+  return true;
+}
+
+bool FunctionInlineHookRouting::RemoveReplaceCall(dobby_dummy_func_t replace_func) {
+  auto chain = chain_;
+  int index = -1;
+  for (uint32_t i = 0; i < chain->count; i++) {
+    if (chain->links[i]->replace_func == replace_func) {
+      index = (int)i;
+      break;
+    }
+  }
+  if (index == -1 || chain->count == 1)
+    return false;
+
+  // the hook above jumps over the link, which stays with its bridge for the calls already in it
+  auto link = chain->links[index];
+  addr_t *prev_hop = index == 0 ? &head_ : &chain->links[index - 1]->next_hop;
+  __atomic_store_n(prev_hop, link->next_hop, __ATOMIC_RELEASE);
+  PublishChain(nullptr, index);
+  return true;
 }
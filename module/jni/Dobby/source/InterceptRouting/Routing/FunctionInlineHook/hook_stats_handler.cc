@@ -0,0 +1,115 @@
+#include "dobby/dobby_internal.h"
+
+#include "InterceptRouting/Routing/FunctionInlineHook/FunctionInlineHookRouting.h"
+#include "InterceptRouting/Routing/FunctionInlineHook/hook_stats_handler.h"
+
+#include "Backend/UserMode/MultiThreadSupport/ThreadSupport.h"
+
+#include "TrampolineBridge/ClosureTrampolineBridge/common_bridge_handler.h"
+
+#include <time.h>
+
+static bool hook_stats_enabled_ = false;
+
+PUBLIC void dobby_enable_hook_stats() {
+  hook_stats_enabled_ = true;
+}
+
+PUBLIC void dobby_disable_hook_stats() {
+  hook_stats_enabled_ = false;
+}
+
+bool hook_stats_enabled() {
+  return hook_stats_enabled_;
+}
+
+HookStats *hook_stats_create() {
+  // page aligned and zeroed
+  return (HookStats *)OSMemory::Allocate(sizeof(HookStats), kReadWrite);
+}
+
+void hook_stats_aggregate(HookStats *stats, DobbyHookStats *out) {
+  memset(out, 0, sizeof(DobbyHookStats));
+  for (int i = 0; i < DOBBY_HOOK_STATS_THREADS; i++) {
+    HookStatsShard *shard = &stats->shards[i];
+    uint64_t max_ns = __atomic_load_n(&shard->max_ns, __ATOMIC_RELAXED);
+    out->hits += __atomic_load_n(&shard->hits, __ATOMIC_RELAXED);
+    out->timed_calls += __atomic_load_n(&shard->timed_calls, __ATOMIC_RELAXED);
+    out->total_ns += __atomic_load_n(&shard->total_ns, __ATOMIC_RELAXED);
+    if (max_ns > out->max_ns)
+      out->max_ns = max_ns;
+    for (int j = 0; j < DOBBY_HOOK_STATS_BUCKETS; j++)
+      out->histogram[j] += __atomic_load_n(&shard->histogram[j], __ATOMIC_RELAXED);
+    out->threads[i].tid = __atomic_load_n(&shard->tid, __ATOMIC_RELAXED);
+    out->threads[i].hits = __atomic_load_n(&shard->hits, __ATOMIC_RELAXED);
+  }
+}
+
+// threads take the slots in the order of their first hooked call, wrapping around
+static int stats_slot_count_ = 0;
+static thread_local int stats_slot_ = -1;
+static thread_local int stats_tid_ = 0;
+
+static HookStatsShard *current_shard(HookStats *stats) {
+  if (stats_slot_ == -1) {
+    stats_slot_ = __atomic_fetch_add(&stats_slot_count_, 1, __ATOMIC_RELAXED) % DOBBY_HOOK_STATS_THREADS;
+    stats_tid_ = base::ThreadInterface::CurrentId();
+  }
+  return &stats->shards[stats_slot_];
+}
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// four linear buckets per power of two
+static int latency_bucket(uint64_t ns) {
+  if (ns < 4)
+    return (int)ns;
+  int msb = 63 - __builtin_clzll(ns);
+  int bucket = (msb - 1) * 4 + (int)((ns >> (msb - 2)) & 3);
+  return bucket < DOBBY_HOOK_STATS_BUCKETS ? bucket : DOBBY_HOOK_STATS_BUCKETS - 1;
+}
+
+void hook_stats_dispatch(InterceptEntry *entry, DobbyRegisterContext *ctx) {
+  auto routing = static_cast<FunctionInlineHookRouting *>(entry->routing);
+  HookStatsShard *shard = current_shard(routing->stats);
+  __atomic_fetch_add(&shard->hits, 1, __ATOMIC_RELAXED);
+  __atomic_store_n(&shard->tid, stats_tid_, __ATOMIC_RELAXED);
+
+  // time the call while the shadow stack has room
+  StackFrame *stackframe = ThreadSupport::PushStackFrame(get_func_ret_sp(ctx, true), get_func_ret_address(ctx));
+  if (stackframe) {
+    stackframe->entry = entry;
+    stackframe->orig_ret = get_func_ret_address(ctx);
+    stackframe->ret_bridge = routing->stats_epilogue_bridge;
+    set_func_ret_address(ctx, routing->stats_epilogue_bridge);
+    stackframe->user_ctx.slots[0] = (uintptr_t)now_ns();
+  }
+
+  set_routing_bridge_next_hop(ctx, (void *)routing->GetReplaceCall());
+}
+
+void hook_stats_leave_dispatch(InterceptEntry *entry, DobbyRegisterContext *ctx) {
+  uint64_t end = now_ns();
+  StackFrame *top = ThreadSupport::PopStackFrame(get_func_ret_sp(ctx, false));
+  // the frame holds the only copy of the return address, returning anywhere else would run garbage
+  if (top == nullptr || top->entry != entry) {
+    FATAL_LOG("[hook stats] %p returned without its shadow stack frame", entry->patched_addr);
+    abort();
+  }
+
+  auto routing = static_cast<FunctionInlineHookRouting *>(entry->routing);
+  uint64_t ns = end - (uint64_t)top->user_ctx.slots[0];
+  HookStatsShard *shard = current_shard(routing->stats);
+  __atomic_fetch_add(&shard->timed_calls, 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&shard->total_ns, ns, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&shard->histogram[latency_bucket(ns)], 1, __ATOMIC_RELAXED);
+  // threads sharing the slot may race on the max, the histogram keeps the tail
+  if (ns > __atomic_load_n(&shard->max_ns, __ATOMIC_RELAXED))
+    __atomic_store_n(&shard->max_ns, ns, __ATOMIC_RELAXED);
+
+  set_routing_bridge_next_hop(ctx, top->orig_ret);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "dobby/dobby_internal.h"
+
+// statistics of the calling threads in one slot, each slot on its own cache lines
+typedef struct {
+  alignas(64) uint64_t hits;
+  uint64_t timed_calls;
+  uint64_t total_ns;
+  uint64_t max_ns;
+  // last caller
+  int tid;
+  uint64_t histogram[DOBBY_HOOK_STATS_BUCKETS];
+} HookStatsShard;
+
+typedef struct {
+  HookStatsShard shards[DOBBY_HOOK_STATS_THREADS];
+} HookStats;
+
+// hooks prepared while enabled route through the stats bridges
+bool hook_stats_enabled();
+
+HookStats *hook_stats_create();
+
+void hook_stats_aggregate(HookStats *stats, DobbyHookStats *out);
+
+extern "C" {
+void hook_stats_dispatch(InterceptEntry *entry, DobbyRegisterContext *ctx);
+
+void hook_stats_leave_dispatch(InterceptEntry *entry, DobbyRegisterContext *ctx);
+}
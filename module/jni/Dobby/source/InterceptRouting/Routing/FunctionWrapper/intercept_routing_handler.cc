@@ -8,16 +8,15 @@
 #include "function-wrapper.h"
 #include "intercept_routing_handler.h"
 
-#include "MultiThreadSupport/ThreadSupport.h"
+#include "Backend/UserMode/MultiThreadSupport/ThreadSupport.h"
 
 #include "TrampolineBridge/ClosureTrampolineBridge/common_bridge_handler.h"
 
 void pre_call_forward_handler(DobbyRegisterContext *ctx, InterceptEntry *entry) {
   FunctionWrapperRouting *routing = (FunctionWrapperRouting *)entry->routing;
 
-  StackFrame *stackframe = new StackFrame();
   // create stack frame as common variable between pre_call and post_call
-  ThreadSupport::PushStackFrame(stackframe);
+  StackFrame *stackframe = ThreadSupport::PushStackFrame(get_func_ret_sp(ctx, true), get_func_ret_address(ctx));
 
   // run the `pre_call` before execute origin function which has been relocated(fixed)
   if (routing->pre_call) {
@@ -37,6 +36,7 @@ void pre_call_forward_handler(DobbyRegisterContext *ctx, InterceptEntry *entry)
   set_routing_bridge_next_hop(ctx, entry->relocated_origin_function);
 
   // replace the function ret address with our epilogue_routing_dispatch
+  stackframe->ret_bridge = entry->epilogue_dispatch_bridge;
   set_func_ret_address(ctx, entry->epilogue_dispatch_bridge);
 }
 
@@ -44,7 +44,7 @@ void post_call_forward_handler(DobbyRegisterContext *ctx, InterceptEntry *entry)
   FunctionWrapperRouting *routing = (FunctionWrapperRouting *)entry->routing;
 
   // pop stack frame as common variable between pre_call and post_call
-  StackFrame *stackframe = ThreadSupport::PopStackFrame();
+  StackFrame *stackframe = ThreadSupport::PopStackFrame(get_func_ret_sp(ctx, false));
 
   // run the `post_call`, and access all the register value, as the origin function done,
   if (routing->post_call) {
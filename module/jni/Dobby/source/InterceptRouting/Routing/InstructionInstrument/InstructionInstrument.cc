@@ -4,7 +4,7 @@
 #include "InterceptRouting/InterceptRouting.h"
 #include "InterceptRouting/Routing/InstructionInstrument/InstructionInstrumentRouting.h"
 
-PUBLIC int DobbyInstrument(void *address, dobby_instrument_callback_t pre_handler) {
+static int instrument(void *address, const InstrumentListener &listener, uint64_t register_mask) {
   if (!address) {
     ERROR_LOG("address is 0x0.\n");
     return -1;
@@ -23,20 +23,93 @@ PUBLIC int DobbyInstrument(void *address, dobby_instrument_callback_t pre_handle
 
   DEBUG_LOG("\n\n----- [DobbyInstrument:%p] -----", address);
 
+  // listeners share the trampoline of an instrumented address, the register mask only applies to the first one
   auto entry = Interceptor::SharedInstance()->find((addr_t)address);
   if (entry) {
-    ERROR_LOG("%s already been instrumented.", address);
-    return -1;
+    if (entry->type != kInstructionInstrument) {
+      ERROR_LOG("%p already been hooked.", address);
+      return -1;
+    }
+    auto routing = static_cast<InstructionInstrumentRouting *>(entry->routing);
+    return routing->AddListener(listener) ? 0 : -1;
   }
 
   entry = new InterceptEntry(kInstructionInstrument, (addr_t)address);
 
-  auto routing = new InstructionInstrumentRouting(entry, pre_handler, nullptr);
+  auto routing = new InstructionInstrumentRouting(entry);
+  routing->register_mask = register_mask;
+  routing->AddListener(listener);
   routing->Prepare();
   routing->DispatchRouting();
+  if (routing->GetTrampolineBuffer() == nullptr) {
+    ERROR_LOG("%p no safe trampoline.", address);
+    delete routing;
+    delete entry;
+    return -1;
+  }
   routing->Commit();
 
   Interceptor::SharedInstance()->add(entry);
 
   return 0;
 }
+
+PUBLIC int DobbyInstrument(void *address, dobby_instrument_callback_t pre_handler) {
+  InstrumentListener listener = {pre_handler, nullptr, nullptr, nullptr, nullptr};
+  return instrument(address, listener, DOBBY_REG_MASK_ALL);
+}
+
+PUBLIC int DobbyInstrumentWithRegisterMask(void *address, dobby_instrument_callback_t pre_handler,
+                                           uint64_t register_mask) {
+  if (!pre_handler) {
+    ERROR_LOG("pre_handler is required with a register mask.\n");
+    return -1;
+  }
+  InstrumentListener listener = {pre_handler, nullptr, nullptr, nullptr, nullptr};
+  return instrument(address, listener, register_mask);
+}
+
+PUBLIC int DobbyInstrumentEnterLeave(void *address, dobby_instrument_enter_callback_t on_enter,
+                                     dobby_instrument_leave_callback_t on_leave) {
+  InstrumentListener listener = {nullptr, on_enter, on_leave, nullptr, nullptr};
+  return instrument(address, listener, DOBBY_REG_MASK_ALL);
+}
+
+PUBLIC int DobbyInstrumentCounter(void *address, uint64_t *counter) {
+  if (!counter) {
+    ERROR_LOG("counter is 0x0.\n");
+    return -1;
+  }
+  InstrumentListener listener = {nullptr, nullptr, nullptr, counter, nullptr};
+  return instrument(address, listener, DOBBY_REG_MASK_ALL);
+}
+
+PUBLIC int DobbyInstrumentSampled(void *address, dobby_instrument_callback_t pre_handler, uint32_t every_nth,
+                                  uint64_t interval_ns) {
+  static int32_t sampler_slots = 0;
+
+  if (!pre_handler) {
+    ERROR_LOG("pre_handler is required for sampling.\n");
+    return -1;
+  }
+  if (interval_ns && sampler_slots == INSTRUMENT_SAMPLER_SLOTS) {
+    ERROR_LOG("no sampler slot left for an interval.\n");
+    return -1;
+  }
+
+  // the listener array copies the listener, the sampler stays in place for the bridge
+  auto sampler = new InstrumentSampler;
+  sampler->countdown = every_nth > 1 ? (int32_t)every_nth : 1;
+  sampler->every_nth = every_nth;
+  sampler->interval_ns = interval_ns;
+  sampler->slot = interval_ns ? sampler_slots : -1;
+
+  InstrumentListener listener = {pre_handler, nullptr, nullptr, nullptr, sampler};
+  if (instrument(address, listener, DOBBY_REG_MASK_ALL) != 0) {
+    delete sampler;
+    return -1;
+  }
+  if (interval_ns)
+    sampler_slots++;
+  return 0;
+}
@@ -6,25 +6,82 @@
 
 #include "TrampolineBridge/ClosureTrampolineBridge/ClosureTrampoline.h"
 
+// thread local last sample times, one slot per sampler with an interval
+#define INSTRUMENT_SAMPLER_SLOTS 64
+
+typedef struct {
+  // calls left until the next sample, shared by all threads and counted down without atomic read-modify-write
+  int32_t countdown;
+  uint32_t every_nth;
+  // minimum time between two samples on a thread, 0 for none
+  uint64_t interval_ns;
+  // slot of the last sample time, -1 without an interval
+  int32_t slot;
+} InstrumentSampler;
+
+typedef struct {
+  dobby_instrument_callback_t pre_handler;
+
+  // function entry instrument, the leave handler runs through the epilogue bridge installed as return address
+  dobby_instrument_enter_callback_t enter_handler;
+  dobby_instrument_leave_callback_t leave_handler;
+
+  // hit counter, incremented before the handlers
+  uint64_t *counter;
+
+  // the handlers only run on sampled calls, the counter counts every call
+  InstrumentSampler *sampler;
+} InstrumentListener;
+
+// immutable once published, adding a listener publishes a copy
+typedef struct {
+  uint32_t count;
+  // the only listener with a leave handler, it owns the shadow stack frame context, -1 if none
+  int32_t leave_index;
+  InstrumentListener listeners[1];
+} InstrumentListenerArray;
+
 class InstructionInstrumentRouting : public InterceptRouting {
 public:
-  InstructionInstrumentRouting(InterceptEntry *entry, dobby_instrument_callback_t pre_handler,
-                               dobby_instrument_callback_t post_handler)
-      : InterceptRouting(entry) {
+  InstructionInstrumentRouting(InterceptEntry *entry) : InterceptRouting(entry) {
     this->prologue_dispatch_bridge = nullptr;
-    this->pre_handler = pre_handler;
-    this->post_handler = post_handler;
+    this->epilogue_dispatch_bridge = nullptr;
+    this->listeners_ = nullptr;
+    this->register_mask = DOBBY_REG_MASK_ALL;
+    this->direct_call_bridge_ = false;
+    this->countdown_in_bridge = false;
+    this->next_hop_bridge_ = nullptr;
   }
 
   void DispatchRouting() override;
 
+  // append a listener, one trampoline and relocated prologue serve all of them
+  bool AddListener(const InstrumentListener &listener);
+
+  const InstrumentListenerArray *GetListeners() {
+    return __atomic_load_n(&listeners_, __ATOMIC_ACQUIRE);
+  }
+
 private:
   void BuildRouting();
 
 public:
-  dobby_instrument_callback_t pre_handler;
-  dobby_instrument_callback_t post_handler;
+  void *epilogue_dispatch_bridge;
+
+  // registers saved around the first pre_handler, anything but DOBBY_REG_MASK_ALL builds a specialized bridge
+  uint64_t register_mask;
+
+  // the sampler bridge counts down for the first listener, only its sampled calls enter the closure bridge
+  bool countdown_in_bridge;
 
 private:
   void *prologue_dispatch_bridge;
+
+  InstrumentListenerArray *listeners_;
+
+  // the specialized, counter or sampler bridge serves the first listener itself, it can't dispatch to more listeners
+  bool direct_call_bridge_;
+
+  // counter or sampler bridge, its next hop literal is written after relocation
+  ClosureTrampolineEntry *next_hop_bridge_;
 };
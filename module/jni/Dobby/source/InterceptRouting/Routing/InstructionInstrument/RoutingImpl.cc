@@ -8,11 +8,56 @@
 
 // create closure trampoline jump to prologue_routing_dispatch with the `entry_` data
 void InstructionInstrumentRouting::BuildRouting() {
-  void *handler = (void *)instrument_routing_dispatch;
+  ClosureTrampolineEntry *closure_trampoline = nullptr;
+  auto listeners = GetListeners();
+  if (register_mask != DOBBY_REG_MASK_ALL && listeners->count == 1 && listeners->listeners[0].pre_handler) {
+    // call pre_handler directly, saving only the live registers
+    void *handler = (void *)listeners->listeners[0].pre_handler;
 #if defined(__APPLE__) && defined(__arm64__)
-  handler = pac_strip(handler);
+    handler = pac_strip(handler);
 #endif
-  auto closure_trampoline = ClosureTrampoline::CreateClosureTrampoline(entry_, handler);
+    closure_trampoline = ClosureTrampoline::CreateInstrumentBridge((void *)entry_->patched_addr, handler,
+                                                                   &entry_->relocated_addr, register_mask);
+    if (closure_trampoline == nullptr)
+      DEBUG_LOG("[instrument bridge] no specialized bridge, use the closure bridge");
+    else
+      direct_call_bridge_ = true;
+  }
+
+  const InstrumentListener *first = &listeners->listeners[0];
+  if (listeners->count == 1 && first->counter && !first->pre_handler && !first->enter_handler &&
+      !first->leave_handler) {
+    // count without the register context and the handler call
+    closure_trampoline = ClosureTrampoline::CreateCounterBridge(first->counter);
+    if (closure_trampoline == nullptr) {
+      DEBUG_LOG("[counter bridge] no counter bridge, count in the closure bridge");
+    } else {
+      direct_call_bridge_ = true;
+      next_hop_bridge_ = closure_trampoline;
+    }
+  }
+
+  if (closure_trampoline == nullptr) {
+    void *handler = (void *)instrument_routing_dispatch;
+#if defined(__APPLE__) && defined(__arm64__)
+    handler = pac_strip(handler);
+#endif
+    closure_trampoline = ClosureTrampoline::CreateClosureTrampoline(entry_, handler);
+
+    if (listeners->count == 1 && first->sampler && first->sampler->every_nth > 1) {
+      // calls between samples skip the closure bridge
+      auto sampler_bridge = ClosureTrampoline::CreateSamplerBridge(&first->sampler->countdown, first->sampler->every_nth,
+                                                                   closure_trampoline->address);
+      if (sampler_bridge == nullptr) {
+        DEBUG_LOG("[sampler bridge] no sampler bridge, count down in the closure bridge");
+      } else {
+        direct_call_bridge_ = true;
+        countdown_in_bridge = true;
+        next_hop_bridge_ = sampler_bridge;
+        closure_trampoline = sampler_bridge;
+      }
+    }
+  }
   this->SetTrampolineTarget((addr_t)closure_trampoline->address);
   DEBUG_LOG("[closure trampoline] closure trampoline: %p, data: %p", closure_trampoline->address, entry_);
 
@@ -26,11 +71,57 @@ void InstructionInstrumentRouting::BuildRouting() {
   GenerateTrampolineBuffer(from, to);
 }
 
+bool InstructionInstrumentRouting::AddListener(const InstrumentListener &listener) {
+  auto prev = listeners_;
+  if (direct_call_bridge_) {
+    ERROR_LOG("%p is instrumented through a direct bridge, no more listeners.", entry_->patched_addr);
+    return false;
+  }
+  if (listener.leave_handler && prev && prev->leave_index != -1) {
+    ERROR_LOG("%p already has a leave listener.", entry_->patched_addr);
+    return false;
+  }
+
+  if (listener.leave_handler && epilogue_dispatch_bridge == nullptr) {
+    void *handler = (void *)instrument_leave_dispatch;
+#if defined(__APPLE__) && defined(__arm64__)
+    handler = pac_strip(handler);
+#endif
+    auto epilogue_bridge = ClosureTrampoline::CreateClosureTrampoline(entry_, handler);
+    epilogue_dispatch_bridge = epilogue_bridge->address;
+    DEBUG_LOG("[closure trampoline] epilogue bridge: %p", epilogue_dispatch_bridge);
+  }
+
+  uint32_t count = prev ? prev->count + 1 : 1;
+  auto listeners = (InstrumentListenerArray *)malloc(sizeof(InstrumentListenerArray) +
+                                                     (count - 1) * sizeof(InstrumentListener));
+  listeners->count = count;
+  listeners->leave_index = prev ? prev->leave_index : -1;
+  if (prev)
+    memcpy(listeners->listeners, prev->listeners, prev->count * sizeof(InstrumentListener));
+  listeners->listeners[count - 1] = listener;
+  if (listener.leave_handler)
+    listeners->leave_index = count - 1;
+
+  // a bridge may still iterate the previous array, it is never freed
+  __atomic_store_n(&listeners_, listeners, __ATOMIC_RELEASE);
+  return true;
+}
+
 void InstructionInstrumentRouting::DispatchRouting() {
   BuildRouting();
+  if (GetTrampolineBuffer() == nullptr)
+    return;
 
   // generate relocated code which size == trampoline size
-  GenerateRelocatedCode();
+  if (!GenerateRelocatedCode())
+    return;
+
+  if (next_hop_bridge_) {
+    addr_t next_hop = entry_->relocated_addr;
+    auto literal = (uint8_t *)next_hop_bridge_->address + next_hop_bridge_->size - sizeof(addr_t);
+    DobbyCodePatch(literal, (uint8_t *)&next_hop, sizeof(addr_t));
+  }
 }
 
 #if 0
@@ -3,13 +3,69 @@
 #include "InterceptRouting/Routing/InstructionInstrument/InstructionInstrumentRouting.h"
 #include "InterceptRouting/Routing/InstructionInstrument/instrument_routing_handler.h"
 
+#include "Backend/UserMode/MultiThreadSupport/ThreadSupport.h"
+
 #include "TrampolineBridge/ClosureTrampolineBridge/common_bridge_handler.h"
 
+#include <time.h>
+
+static thread_local uint64_t sample_time_[INSTRUMENT_SAMPLER_SLOTS];
+
+// whether this call is sampled, the countdown is already done when the sampler bridge entered the closure bridge
+static bool take_sample(InstrumentSampler *sampler, bool counted_down) {
+  if (!counted_down && sampler->every_nth > 1) {
+    // racing threads may lose a decrement, which only shifts the next sample
+    int32_t left = __atomic_load_n(&sampler->countdown, __ATOMIC_RELAXED) - 1;
+    if (left > 0) {
+      __atomic_store_n(&sampler->countdown, left, __ATOMIC_RELAXED);
+      return false;
+    }
+    __atomic_store_n(&sampler->countdown, (int32_t)sampler->every_nth, __ATOMIC_RELAXED);
+  }
+
+  if (sampler->slot != -1) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    uint64_t now = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+    uint64_t *last = &sample_time_[sampler->slot];
+    if (*last && now - *last < sampler->interval_ns)
+      return false;
+    *last = now;
+  }
+  return true;
+}
+
 void instrument_forward_handler(InterceptEntry *entry, DobbyRegisterContext *ctx) {
   auto routing = static_cast<InstructionInstrumentRouting *>(entry->routing);
-  if (routing->pre_handler) {
-    auto handler = (dobby_instrument_callback_t)routing->pre_handler;
-    (*handler)((void *)entry->patched_addr, ctx);
+  auto listeners = routing->GetListeners();
+
+  // route the return through the epilogue bridge while the shadow stack has room
+  StackFrame *stackframe = nullptr;
+  if (listeners->leave_index != -1)
+    stackframe = ThreadSupport::PushStackFrame(get_func_ret_sp(ctx, true), get_func_ret_address(ctx));
+
+  for (uint32_t i = 0; i < listeners->count; i++) {
+    const InstrumentListener *listener = &listeners->listeners[i];
+    if (listener->counter)
+      __atomic_fetch_add(listener->counter, 1, __ATOMIC_RELAXED);
+    if (listener->sampler && !take_sample(listener->sampler, i == 0 && routing->countdown_in_bridge))
+      continue;
+    if (listener->pre_handler)
+      (*listener->pre_handler)((void *)entry->patched_addr, ctx);
+    if (listener->enter_handler) {
+      DobbyInstrumentContext scratch_ctx = {};
+      DobbyInstrumentContext *user_ctx = &scratch_ctx;
+      if (stackframe && (int32_t)i == listeners->leave_index)
+        user_ctx = &stackframe->user_ctx;
+      (*listener->enter_handler)((void *)entry->patched_addr, ctx, user_ctx);
+    }
+  }
+
+  if (stackframe) {
+    stackframe->entry = entry;
+    stackframe->orig_ret = get_func_ret_address(ctx);
+    stackframe->ret_bridge = routing->epilogue_dispatch_bridge;
+    set_func_ret_address(ctx, routing->epilogue_dispatch_bridge);
   }
 
   // set prologue bridge next hop address as relocated instructions
@@ -19,3 +75,22 @@ void instrument_forward_handler(InterceptEntry *entry, DobbyRegisterContext *ctx
 void instrument_routing_dispatch(InterceptEntry *entry, DobbyRegisterContext *ctx) {
   instrument_forward_handler(entry, ctx);
 }
+
+void instrument_leave_dispatch(InterceptEntry *entry, DobbyRegisterContext *ctx) {
+  StackFrame *top = ThreadSupport::PopStackFrame(get_func_ret_sp(ctx, false));
+  // the frame holds the only copy of the return address, returning anywhere else would run garbage
+  if (top == nullptr || top->entry != entry) {
+    FATAL_LOG("[instrument] %p returned without its shadow stack frame", entry->patched_addr);
+    abort();
+  }
+  // the leave handler may call instrumented functions, which reuse the popped slot
+  StackFrame stackframe = *top;
+
+  auto routing = static_cast<InstructionInstrumentRouting *>(entry->routing);
+  auto listeners = routing->GetListeners();
+  auto leave_handler = listeners->listeners[listeners->leave_index].leave_handler;
+  (*leave_handler)((void *)entry->patched_addr, ctx, &stackframe.user_ctx);
+
+  // set epilogue bridge next hop address with origin ret address, restore the call
+  set_routing_bridge_next_hop(ctx, stackframe.orig_ret);
+}
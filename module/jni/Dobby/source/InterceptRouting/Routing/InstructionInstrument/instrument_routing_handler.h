@@ -4,4 +4,6 @@
 
 extern "C" {
 void instrument_routing_dispatch(InterceptEntry *entry, DobbyRegisterContext *ctx);
+
+void instrument_leave_dispatch(InterceptEntry *entry, DobbyRegisterContext *ctx);
 }
\ No newline at end of file
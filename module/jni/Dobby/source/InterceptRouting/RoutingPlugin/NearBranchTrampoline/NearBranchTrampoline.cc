@@ -12,12 +12,14 @@ PUBLIC void dobby_enable_near_branch_trampoline() {
   RoutingPluginInterface *plugin = new NearBranchTrampolinePlugin;
   RoutingPluginManager::registerPlugin("near_branch_trampoline", plugin);
   RoutingPluginManager::near_branch_trampoline = plugin;
+  RoutingPluginManager::near_branch_trampoline_disabled = false;
 }
 
 PUBLIC void dobby_disable_near_branch_trampoline() {
   NearBranchTrampolinePlugin *plugin = (NearBranchTrampolinePlugin *)RoutingPluginManager::near_branch_trampoline;
   delete plugin;
   RoutingPluginManager::near_branch_trampoline = NULL;
+  RoutingPluginManager::near_branch_trampoline_disabled = true;
 }
 
 #if 0
@@ -30,13 +32,12 @@ int NearBranchTrampolinePlugin::PredefinedTrampolineSize() {
 }
 #endif
 
-extern CodeBufferBase *GenerateNearTrampolineBuffer(InterceptRouting *routing, addr_t from, addr_t to);
+extern bool GenerateNearTrampolineBuffer(InterceptRouting *routing, addr_t from, addr_t to, CodeBufferBase *buffer);
 bool NearBranchTrampolinePlugin::GenerateTrampolineBuffer(InterceptRouting *routing, addr_t src, addr_t dst) {
-  CodeBufferBase *trampoline_buffer;
-  trampoline_buffer = GenerateNearTrampolineBuffer(routing, src, dst);
-  if (trampoline_buffer == NULL)
+  CodeBufferBase trampoline_buffer;
+  if (!GenerateNearTrampolineBuffer(routing, src, dst, &trampoline_buffer))
     return false;
-  routing->SetTrampolineBuffer(trampoline_buffer);
+  routing->SetTrampolineBuffer(&trampoline_buffer);
   return true;
 }
 
@@ -7,6 +7,7 @@
 #include "core/codegen/codegen-arm64.h"
 
 #include "MemoryAllocator/NearMemoryAllocator.h"
+#include "MemoryAllocator/NearVeneerPool.h"
 #include "InstructionRelocation/arm64/InstructionRelocationARM64.h"
 #include "InterceptRouting/RoutingPlugin/RoutingPlugin.h"
 
@@ -15,51 +16,35 @@ using namespace zz::arm64;
 #define ARM64_B_XXX_RANGE ((1 << 25) << 2) // signed
 
 // If BranchType is B_Branch and the branch_range of `B` is not enough
-// build the transfer to forward the b branch
-static AssemblyCode *GenerateFastForwardTrampoline(addr_t src, addr_t dst) {
-  TurboAssembler turbo_assembler_(nullptr);
-#define _ turbo_assembler_.
-
-  // [adrp + add + br branch]
-  auto tramp_size = 3 * 4;
-  auto tramp_mem = NearMemoryAllocator::SharedAllocator()->allocateNearExecMemory(tramp_size, src, ARM64_B_XXX_RANGE);
-  if (tramp_mem == nullptr) {
+// forward the b branch through a veneer from the shared near pool
+static addr_t GenerateFastForwardTrampoline(addr_t src, addr_t dst) {
+  // [ldr + br + #label] veneer, position independent so every slot has the same size
+  auto veneer_size = 4 * 4;
+
+  bool is_new = false;
+  auto veneer = NearVeneerPool::SharedPool()->allocateVeneer(veneer_size, src, ARM64_B_XXX_RANGE, dst, &is_new);
+  if (veneer == 0) {
     ERROR_LOG("search near code block failed");
-    return nullptr;
+    return 0;
   }
-
-  // Use adrp + add branch
-  uint64_t distance = llabs((int64_t)(tramp_mem - dst));
-  uint64_t adrp_range = ((uint64_t)1 << (2 + 19 + 12 - 1));
-  if (distance < adrp_range) {
-    // use adrp + add + br branch == (3 * 4) trampoline size
-    _ AdrpAdd(TMP_REG_0, (uint64_t)tramp_mem, dst);
-    _ br(TMP_REG_0);
-    DEBUG_LOG("forward trampoline use [adrp, add, br]");
-  } else {
-    // use mov + br == (4 * 5) trampoline size
-    _ Mov(TMP_REG_0, dst);
-    _ br(TMP_REG_0);
-    DEBUG_LOG("forward trampoline use  [mov, br]");
-
-    auto tramp_size = turbo_assembler_.GetCodeBuffer()->GetBufferSize();
-    tramp_mem = NearMemoryAllocator::SharedAllocator()->allocateNearExecMemory(tramp_size, src, ARM64_B_XXX_RANGE);
-    if (tramp_mem == nullptr) {
-      ERROR_LOG("Can't found near code chunk");
-      return nullptr;
-    }
+  if (!is_new) {
+    DEBUG_LOG("forward trampoline reuse veneer %p", veneer);
+    return veneer;
   }
 
-  turbo_assembler_.SetRealizedAddress((void *)tramp_mem);
+  TurboAssembler turbo_assembler_((void *)veneer);
+  CodeGen codegen(&turbo_assembler_);
+  codegen.LiteralLdrBranch((uint64_t)dst);
+  turbo_assembler_.RelocBind();
+  DEBUG_LOG("forward trampoline use [ldr, br, #label]");
 
-  AssemblyCode *code = nullptr;
-  code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_);
-  return code;
+  auto buffer = turbo_assembler_.GetCodeBuffer();
+  CHECK_EQ(buffer->GetBufferSize(), veneer_size);
+  DobbyCodePatch((void *)veneer, buffer->GetBuffer(), buffer->GetBufferSize());
+  return veneer;
 }
 
-CodeBufferBase *GenerateNearTrampolineBuffer(InterceptRouting *routing, addr_t src, addr_t dst) {
-  CodeBufferBase *result = nullptr;
-
+bool GenerateNearTrampolineBuffer(InterceptRouting *routing, addr_t src, addr_t dst, CodeBufferBase *buffer) {
   TurboAssembler turbo_assembler_((void *)src);
 #define _ turbo_assembler_.
 
@@ -69,13 +54,14 @@ CodeBufferBase *GenerateNearTrampolineBuffer(InterceptRouting *routing, addr_t s
   } else {
     auto fast_forward_trampoline = GenerateFastForwardTrampoline(src, dst);
     if (!fast_forward_trampoline)
-      return nullptr;
-    _ b(fast_forward_trampoline->addr - src);
+      return false;
+    _ b(fast_forward_trampoline - src);
+    routing->SetNearVeneer(fast_forward_trampoline);
+    routing->GetInterceptEntry()->trampoline_kind = kDobbyTrampolineNearVeneer;
   }
 
-  // free the original trampoline
-  result = turbo_assembler_.GetCodeBuffer()->Copy();
-  return result;
+  buffer->CopyFrom(turbo_assembler_.GetCodeBuffer());
+  return true;
 }
 
 #endif
@@ -4,6 +4,8 @@ tinystl::vector<RoutingPluginInterface *> RoutingPluginManager::plugins;
 
 RoutingPluginInterface *RoutingPluginManager::near_branch_trampoline = NULL;
 
+bool RoutingPluginManager::near_branch_trampoline_disabled = false;
+
 void RoutingPluginManager::registerPlugin(const char *name, RoutingPluginInterface *plugin) {
   DEBUG_LOG("register %s plugin", name);
 
@@ -27,4 +27,7 @@ public:
   static tinystl::vector<RoutingPluginInterface *> plugins;
 
   static RoutingPluginInterface *near_branch_trampoline;
+
+  // opt out of the default near branch trampoline of Arm64
+  static bool near_branch_trampoline_disabled;
 };
@@ -1,9 +1,10 @@
 #include "MemoryAllocator/AssemblyCodeBuilder.h"
+#include "MemoryAllocator/PerfMap.h"
 
 #include "dobby/dobby_internal.h"
 #include "PlatformUnifiedInterface/ExecMemory/CodePatchTool.h"
 
-AssemblyCode *AssemblyCodeBuilder::FinalizeFromTurboAssembler(AssemblerBase *assembler) {
+AssemblyCode *AssemblyCodeBuilder::FinalizeFromTurboAssembler(AssemblerBase *assembler, const char *kind, addr_t target) {
   auto buffer = (CodeBufferBase *)assembler->GetCodeBuffer();
   auto realized_addr = (addr_t)assembler->GetRealizedAddress();
 #if defined(TEST_WITH_UNICORN)
@@ -29,6 +30,8 @@ AssemblyCode *AssemblyCodeBuilder::FinalizeFromTurboAssembler(AssemblerBase *ass
   // Realize the buffer code to the executable memory address, remove the external label, etc
   DobbyCodePatch((void *)realized_addr, buffer->GetBuffer(), buffer->GetBufferSize());
 
+  PerfMap::Record(realized_addr, buffer->GetBufferSize(), kind, target);
+
   auto block = new AssemblyCode(realized_addr, buffer->GetBufferSize());
   return block;
 }
\ No newline at end of file
@@ -10,5 +10,7 @@ using AssemblyCode = CodeMemBlock;
 
 class AssemblyCodeBuilder {
 public:
-  static AssemblyCode *FinalizeFromTurboAssembler(AssemblerBase *assembler);
+  // kind and target name the code in the perf map
+  static AssemblyCode *FinalizeFromTurboAssembler(AssemblerBase *assembler, const char *kind = "code",
+                                                  addr_t target = 0);
 };
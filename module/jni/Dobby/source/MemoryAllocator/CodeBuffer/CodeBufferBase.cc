@@ -1,9 +1,45 @@
 #include "MemoryAllocator/CodeBuffer/CodeBufferBase.h"
 
-CodeBufferBase *CodeBufferBase::Copy() {
-  CodeBufferBase *result = new CodeBufferBase();
-  result->EmitBuffer(GetBuffer(), GetBufferSize());
-  return result;
+#include "PlatformUnifiedInterface/platform.h"
+
+#define CODE_BUFFER_ARENA_SIZE (64 * 1024)
+
+// per thread scratch memory for the buffers which outgrew their inline storage, mostly the assembler buffers of one
+// hook generation. The storage left behind by a growing buffer is reclaimed once no buffer of the thread uses it.
+// Plain data without a destructor, no thread exit handler keeps the library loaded, the block is given back with its
+// last user instead
+struct CodeBufferArena {
+  uint8_t *base;
+  size_t top;
+  int users;
+};
+static thread_local CodeBufferArena thread_arena_;
+
+// the block of an arena without users, kept for the next one rather than unmapped
+static uint8_t *spare_arena_block_ = nullptr;
+
+static uint8_t *take_arena_block() {
+  uint8_t *block = __atomic_exchange_n(&spare_arena_block_, nullptr, __ATOMIC_ACQUIRE);
+  if (block == nullptr)
+    block = (uint8_t *)OSMemory::Allocate(CODE_BUFFER_ARENA_SIZE, kReadWrite);
+  return block;
+}
+
+static void give_arena_block(uint8_t *block) {
+  block = __atomic_exchange_n(&spare_arena_block_, block, __ATOMIC_ACQ_REL);
+  if (block)
+    OSMemory::Free(block, CODE_BUFFER_ARENA_SIZE);
+}
+
+CodeBufferBase::~CodeBufferBase() {
+  ReleaseStorage();
+}
+
+void CodeBufferBase::CopyFrom(CodeBufferBase *buffer) {
+  if (buffer == this)
+    return;
+  Reset();
+  EmitBuffer(buffer->GetBuffer(), buffer->GetBufferSize());
 }
 
 void CodeBufferBase::Emit8(uint8_t data) {
@@ -23,15 +59,76 @@ void CodeBufferBase::Emit64(uint64_t data) {
 }
 
 void CodeBufferBase::EmitBuffer(uint8_t *buffer, int buffer_size) {
-  buffer_.insert(buffer_.end(), buffer, buffer + buffer_size);
+  if (size_ + buffer_size > capacity_)
+    Grow(size_ + buffer_size);
+  memcpy(buffer_ + size_, buffer, buffer_size);
+  size_ += buffer_size;
 }
 
 uint8_t *CodeBufferBase::GetBuffer() {
-  return buffer_.data();
+  return buffer_;
 }
 
 size_t CodeBufferBase::GetBufferSize() {
-  return buffer_.size();
+  return size_;
+}
+
+void CodeBufferBase::Grow(size_t size) {
+  size_t capacity = capacity_ * 2;
+  while (capacity < size)
+    capacity *= 2;
+
+  CodeBufferArena *arena = &thread_arena_;
+
+  // the top of the arena grows in place
+  if (arena_ == arena && buffer_ + capacity_ == arena->base + arena->top &&
+      (size_t)(buffer_ - arena->base) + capacity <= CODE_BUFFER_ARENA_SIZE) {
+    arena->top = (buffer_ - arena->base) + capacity;
+    capacity_ = capacity;
+    return;
+  }
+
+  uint8_t *storage;
+  bool in_arena = arena->top + capacity <= CODE_BUFFER_ARENA_SIZE;
+  if (in_arena && arena->base == nullptr) {
+    arena->base = take_arena_block();
+    in_arena = arena->base != nullptr;
+  }
+  if (in_arena) {
+    storage = arena->base + arena->top;
+    arena->top += capacity;
+    // before releasing the old storage, which may be the last user of the arena
+    arena->users++;
+  } else {
+    storage = (uint8_t *)malloc(capacity);
+  }
+  memcpy(storage, buffer_, size_);
+
+  ReleaseStorage();
+  buffer_ = storage;
+  capacity_ = capacity;
+  arena_ = in_arena ? arena : nullptr;
+  heap_ = !in_arena;
+}
+
+void CodeBufferBase::ReleaseStorage() {
+  if (heap_) {
+    free(buffer_);
+  } else if (arena_ != nullptr && arena_ == &thread_arena_) {
+    // a buffer destroyed on another thread leaves its storage to the arena of the creating thread
+    if (buffer_ + capacity_ == arena_->base + arena_->top)
+      arena_->top -= capacity_;
+    if (--arena_->users == 0) {
+      give_arena_block(arena_->base);
+      arena_->base = nullptr;
+      arena_->top = 0;
+    }
+  }
+
+  buffer_ = inline_buffer_;
+  capacity_ = CODE_BUFFER_INLINE_SIZE;
+  arena_ = nullptr;
+  heap_ = false;
 }
 
 #if 0 // Template Advanced won't enable even in userspace
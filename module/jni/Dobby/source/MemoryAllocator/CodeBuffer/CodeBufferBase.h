@@ -2,13 +2,36 @@
 
 #include "dobby/common.h"
 
+// bytes kept in the buffer itself, enough for trampolines, closure trampolines and typical relocated prologues
+#define CODE_BUFFER_INLINE_SIZE 128
+
+struct CodeBufferArena;
+
+// code buffer growing from its inline storage into the scratch arena of the creating thread, and into the heap once
+// the arena is full. Buffers outgrowing the inline storage are scratch memory, destroy them on the creating thread
 class CodeBufferBase {
 public:
   CodeBufferBase() {
+    buffer_ = inline_buffer_;
+    size_ = 0;
+    capacity_ = CODE_BUFFER_INLINE_SIZE;
+    arena_ = nullptr;
+    heap_ = false;
   }
 
+  ~CodeBufferBase();
+
+  CodeBufferBase(const CodeBufferBase &) = delete;
+  CodeBufferBase &operator=(const CodeBufferBase &) = delete;
+
 public:
-  virtual CodeBufferBase *Copy();
+  // replace the content with a copy of buffer
+  void CopyFrom(CodeBufferBase *buffer);
+
+  // drop the content, keeping the storage
+  void Reset() {
+    size_ = 0;
+  }
 
   void Emit8(uint8_t data);
 
@@ -19,11 +42,11 @@ public:
   void Emit64(uint64_t data);
 
   template <typename T> T Load(int offset) {
-    return *(T *)(buffer_.data() + offset);
+    return *(T *)(buffer_ + offset);
   }
 
   template <typename T> void Store(int offset, T value) {
-    *(T *)(buffer_.data() + offset) = value;
+    *(T *)(buffer_ + offset) = value;
   }
 
   template <typename T> void Emit(T value) {
@@ -36,5 +59,18 @@ public:
   size_t GetBufferSize();
 
 private:
-  tinystl::vector<uint8_t> buffer_;
+  void Grow(size_t size);
+
+  void ReleaseStorage();
+
+private:
+  uint8_t *buffer_;
+  size_t size_;
+  size_t capacity_;
+
+  // arena of the storage, nullptr for the inline or heap storage
+  CodeBufferArena *arena_;
+  bool heap_;
+
+  uint8_t inline_buffer_[CODE_BUFFER_INLINE_SIZE];
 };
@@ -107,57 +107,99 @@ MemBlock *NearMemoryAllocator::allocateNearBlockFromDefaultAllocator(uint32_t si
   return block;
 }
 
-MemBlock *NearMemoryAllocator::allocateNearBlockFromUnusedRegion(uint32_t size, addr_t pos, size_t search_range,
-                                                                 bool executable) {
-
-  addr_t min_valid_addr, max_valid_addr;
-  min_valid_addr = pos - search_range;
-  max_valid_addr = pos + search_range;
-
-  auto check_has_sufficient_memory_between_region = [&](MemRegion region, MemRegion next_region,
-                                                        uint32_t size) -> addr_t {
-    addr_t unused_mem_start = region.start + region.size;
-    addr_t unused_mem_end = next_region.start;
+// free gaps between the mapped regions, sorted by address
+typedef struct mem_gap {
+  addr_t start;
+  addr_t end;
+} mem_gap_t;
+
+static void mem_gap_index_build(const tinystl::vector<MemRegion> &regions, tinystl::vector<mem_gap_t> &gaps) {
+  gaps.clear();
+  for (size_t i = 0; i + 1 < regions.size(); i++) {
+    addr_t gap_start = regions[i].start + regions[i].size;
+    addr_t gap_end = regions[i + 1].start;
+    if (gap_start < gap_end)
+      gaps.push_back({gap_start, gap_end});
+  }
+}
 
-    // check if unused region total out of search range
-    if (unused_mem_end < min_valid_addr || unused_mem_start > max_valid_addr)
-      return 0;
+// closest page aligned address to pos in the gap, [addr, addr + size) stays in the valid range
+static addr_t mem_gap_closest_addr(const mem_gap_t &gap, uint32_t size, addr_t pos, addr_t min_valid_addr,
+                                   addr_t max_valid_addr) {
+  addr_t page_size = OSMemory::PageSize();
+  addr_t lo = ALIGN_CEIL(max(gap.start, min_valid_addr), page_size);
+  addr_t hi_end = min(gap.end, max_valid_addr);
+  if (hi_end < lo + size)
+    return 0;
+  addr_t hi = ALIGN_FLOOR(hi_end - size, page_size);
+  if (hi < lo)
+    return 0;
+
+  addr_t addr = ALIGN_FLOOR(pos, page_size);
+  addr = max(addr, lo);
+  addr = min(addr, hi);
+  return addr;
+}
 
-    // align
-    unused_mem_start = ALIGN_FLOOR(unused_mem_start, 4);
+static addr_t mem_gap_index_search_closest(const tinystl::vector<mem_gap_t> &gaps, uint32_t size, addr_t pos,
+                                           addr_t min_valid_addr, addr_t max_valid_addr) {
+  // first gap ending above pos
+  size_t lo = 0, hi = gaps.size();
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (gaps[mid].end <= pos)
+      lo = mid + 1;
+    else
+      hi = mid;
+  }
 
-    unused_mem_start = max(unused_mem_start, min_valid_addr);
-    unused_mem_end = min(unused_mem_end, max_valid_addr);
+  addr_t best = 0;
+  addr_t best_distance = (addr_t)-1;
+  auto distance_to = [&](addr_t addr) -> addr_t { return addr > pos ? addr - pos : pos - addr; };
 
-    // check if invalid
-    if (unused_mem_start >= unused_mem_end)
-      return 0;
+  // walk outward on both sides, stop when the gap itself is farther than the best candidate
+  for (size_t i = lo; i < gaps.size(); i++) {
+    if (gaps[i].start > max_valid_addr || (gaps[i].start > pos && gaps[i].start - pos >= best_distance))
+      break;
+    addr_t addr = mem_gap_closest_addr(gaps[i], size, pos, min_valid_addr, max_valid_addr);
+    if (addr && distance_to(addr) < best_distance) {
+      best = addr;
+      best_distance = distance_to(addr);
+    }
+  }
+  for (size_t i = lo; i > 0; i--) {
+    auto &gap = gaps[i - 1];
+    if (gap.end < min_valid_addr || pos - gap.end >= best_distance)
+      break;
+    addr_t addr = mem_gap_closest_addr(gap, size, pos, min_valid_addr, max_valid_addr);
+    if (addr && distance_to(addr) < best_distance) {
+      best = addr;
+      best_distance = distance_to(addr);
+    }
+  }
+  return best;
+}
 
-    // check if has sufficient memory
-    if (unused_mem_end - unused_mem_start < size)
-      return 0;
+MemBlock *NearMemoryAllocator::allocateNearBlockFromUnusedRegion(uint32_t size, addr_t pos, size_t search_range,
+                                                                 bool executable) {
 
-    DEBUG_LOG("[near memory allocator] unused memory from unused region %p(%p), within pos: %p, serach_range: %p",
-              unused_mem_start, size, pos, search_range);
-    return unused_mem_start;
-  };
+  addr_t min_valid_addr, max_valid_addr;
+  min_valid_addr = pos > search_range ? pos - search_range : 0;
+  max_valid_addr = pos + search_range;
 
-  addr_t unused_mem = 0;
-  auto regions = ProcessRuntimeUtility::GetProcessMemoryLayout();
-  for (size_t i = 0; i + 1 < regions.size(); i++) {
-    unused_mem = check_has_sufficient_memory_between_region(regions[i], regions[i + 1], size);
-    if (unused_mem == 0)
-      continue;
-    break;
-  }
+  // the index is rebuilt from a fresh snapshot, the fixed mapping below must not hit a stale gap
+  static tinystl::vector<mem_gap_t> gaps;
+  mem_gap_index_build(ProcessRuntimeUtility::GetProcessMemoryLayout(), gaps);
 
+  addr_t unused_mem = mem_gap_index_search_closest(gaps, size, pos, min_valid_addr, max_valid_addr);
   if (!unused_mem)
     return nullptr;
 
-  auto unused_arena_first_page_addr = (addr_t)ALIGN_FLOOR(unused_mem, OSMemory::PageSize());
-  auto unused_arena_end_page_addr = ALIGN_FLOOR(unused_mem + size, OSMemory::PageSize());
-  auto unused_arena_size = unused_arena_end_page_addr - unused_arena_first_page_addr + OSMemory::PageSize();
-  auto unused_arena_addr = unused_arena_first_page_addr;
+  DEBUG_LOG("[near memory allocator] unused memory from unused region %p(%p), within pos: %p, serach_range: %p",
+            unused_mem, size, pos, search_range);
+
+  auto unused_arena_addr = unused_mem;
+  auto unused_arena_size = ALIGN_CEIL(size, OSMemory::PageSize());
 
   if (OSMemory::Allocate(unused_arena_size, kNoAccess, (void *)unused_arena_addr) == nullptr) {
     ERROR_LOG("[near memory allocator] allocate fixed page failed %p", unused_arena_addr);
@@ -179,11 +221,6 @@ MemBlock *NearMemoryAllocator::allocateNearBlockFromUnusedRegion(uint32_t size,
 
   auto unused_arena = register_near_arena(unused_arena_addr, unused_arena_size);
 
-  // skip placeholder block
-  // FIXME: allocate the placeholder but mark it as freed
-  auto placeholder_block_size = unused_mem - unused_arena->cursor_addr;
-  unused_arena->allocMemBlock(placeholder_block_size);
-
   auto block = unused_arena->allocMemBlock(size);
   return block;
 }
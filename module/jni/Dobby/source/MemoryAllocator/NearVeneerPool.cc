@@ -0,0 +1,114 @@
+#include "NearVeneerPool.h"
+
+#include "dobby/dobby_internal.h"
+
+#include "MemoryAllocator/NearMemoryAllocator.h"
+
+NearVeneerPage::NearVeneerPage(addr_t addr, size_t size, uint32_t slot_size)
+    : addr(addr), size(size), slot_size(slot_size) {
+  size_t slot_count = size / slot_size;
+  for (size_t i = 0; i < (slot_count + 63) / 64; i++) {
+    bitmap.push_back(0);
+  }
+  for (size_t i = 0; i < slot_count; i++) {
+    slot_dsts.push_back(0);
+    slot_refs.push_back(0);
+  }
+}
+
+addr_t NearVeneerPage::allocSlot(addr_t dst) {
+  size_t slot_count = slot_dsts.size();
+  for (size_t i = 0; i < bitmap.size(); i++) {
+    if (bitmap[i] == ~0ULL)
+      continue;
+
+    size_t bit = __builtin_ctzll(~bitmap[i]);
+    size_t slot = i * 64 + bit;
+    if (slot >= slot_count)
+      return 0;
+
+    bitmap[i] |= 1ULL << bit;
+    slot_dsts[slot] = dst;
+    slot_refs[slot] = 1;
+    return addr + slot * slot_size;
+  }
+  return 0;
+}
+
+addr_t NearVeneerPage::findSlot(addr_t dst) {
+  for (size_t slot = 0; slot < slot_dsts.size(); slot++) {
+    if (slot_refs[slot] && slot_dsts[slot] == dst) {
+      slot_refs[slot]++;
+      return addr + slot * slot_size;
+    }
+  }
+  return 0;
+}
+
+void NearVeneerPage::releaseSlot(addr_t veneer) {
+  size_t slot = (veneer - addr) / slot_size;
+  if (slot_refs[slot] == 0 || --slot_refs[slot] != 0)
+    return;
+
+  bitmap[slot / 64] &= ~(1ULL << (slot % 64));
+  slot_dsts[slot] = 0;
+}
+
+NearVeneerPool *NearVeneerPool::shared_pool = nullptr;
+NearVeneerPool *NearVeneerPool::SharedPool() {
+  if (NearVeneerPool::shared_pool == nullptr) {
+    NearVeneerPool::shared_pool = new NearVeneerPool();
+  }
+  return NearVeneerPool::shared_pool;
+}
+
+addr_t NearVeneerPool::allocateVeneer(uint32_t slot_size, addr_t pos, size_t search_range, addr_t dst, bool *is_new) {
+  auto page_in_range = [&](NearVeneerPage *page) -> bool {
+    if (page->slot_size != slot_size)
+      return false;
+    return (uint64_t)llabs((int64_t)(page->addr - pos)) < search_range &&
+           (uint64_t)llabs((int64_t)(page->addr + page->size - pos)) < search_range;
+  };
+
+  // reuse the veneer to the same destination
+  for (auto page : pages) {
+    if (!page_in_range(page))
+      continue;
+    addr_t veneer = page->findSlot(dst);
+    if (veneer) {
+      *is_new = false;
+      return veneer;
+    }
+  }
+
+  *is_new = true;
+  for (auto page : pages) {
+    if (!page_in_range(page))
+      continue;
+    addr_t veneer = page->allocSlot(dst);
+    if (veneer)
+      return veneer;
+  }
+
+  // reserve a new page, the only place the near allocator (and the maps scan) is hit
+  auto page_size = OSMemory::PageSize();
+  auto block = NearMemoryAllocator::SharedAllocator()->allocateNearBlock(page_size, pos, search_range, true);
+  if (block == nullptr) {
+    ERROR_LOG("[near veneer pool] allocate veneer page failed, pos: %p", pos);
+    return 0;
+  }
+  DEBUG_LOG("[near veneer pool] new veneer page at: %p, pos: %p", block->addr, pos);
+
+  auto page = new NearVeneerPage(block->addr, block->size, slot_size);
+  pages.push_back(page);
+  return page->allocSlot(dst);
+}
+
+void NearVeneerPool::releaseVeneer(addr_t veneer) {
+  for (auto page : pages) {
+    if (page->contains(veneer)) {
+      page->releaseSlot(veneer);
+      return;
+    }
+  }
+}
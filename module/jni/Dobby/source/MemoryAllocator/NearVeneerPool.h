@@ -0,0 +1,46 @@
+#pragma once
+
+#include "PlatformUnifiedInterface/MemoryAllocator.h"
+
+#include "dobby/common.h"
+
+// one near exec page carved into fixed size veneer slots
+struct NearVeneerPage {
+  addr_t addr;
+  size_t size;
+  uint32_t slot_size;
+
+  // used slot bitmap, destination and reference count of each slot
+  tinystl::vector<uint64_t> bitmap;
+  tinystl::vector<addr_t> slot_dsts;
+  tinystl::vector<uint32_t> slot_refs;
+
+  NearVeneerPage(addr_t addr, size_t size, uint32_t slot_size);
+
+  bool contains(addr_t veneer) {
+    return veneer >= addr && veneer < addr + size;
+  }
+
+  addr_t allocSlot(addr_t dst);
+  addr_t findSlot(addr_t dst);
+  void releaseSlot(addr_t veneer);
+};
+
+// veneers shared by every hook within branch range of the same page,
+// so hooking many functions of one library costs one near mapping
+class NearVeneerPool {
+private:
+  tinystl::vector<NearVeneerPage *> pages;
+
+private:
+  static NearVeneerPool *shared_pool;
+
+public:
+  static NearVeneerPool *SharedPool();
+
+public:
+  // return the slot address, `is_new` is false when a veneer to `dst` within range already exists
+  addr_t allocateVeneer(uint32_t slot_size, addr_t pos, size_t search_range, addr_t dst, bool *is_new);
+
+  void releaseVeneer(addr_t veneer);
+};
@@ -0,0 +1,150 @@
+#include "MemoryAllocator/PerfMap.h"
+
+#if defined(__linux__)
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+
+typedef struct {
+  addr_t addr;
+  size_t size;
+  char name[120];
+} PerfMapRecord;
+
+// records written while enabled, the map of a forked child starts with them. Past the limit a record replaces the
+// oldest one
+#define PERF_MAP_RECORDS_MAX 4096
+static tinystl::vector<PerfMapRecord> *perf_map_records_ = nullptr;
+static size_t perf_map_records_next_ = 0;
+static pthread_mutex_t perf_map_lock_ = PTHREAD_MUTEX_INITIALIZER;
+
+static bool perf_map_enabled_ = false;
+static char perf_map_dir_[256];
+static int perf_map_fd_ = -1;
+static pid_t perf_map_pid_ = 0;
+
+static void write_record(const PerfMapRecord *record) {
+  char line[160];
+  int len = snprintf(line, sizeof(line), "%lx %zx %s\n", (unsigned long)record->addr, record->size, record->name);
+  if (write(perf_map_fd_, line, len) != len)
+    DEBUG_LOG("[perf map] write %s failed", record->name);
+}
+
+// the map is per process, reopen it in a forked child
+static bool open_perf_map() {
+  pid_t pid = getpid();
+  if (perf_map_fd_ != -1 && perf_map_pid_ == pid)
+    return true;
+  if (perf_map_fd_ != -1)
+    close(perf_map_fd_);
+
+  char path[300];
+  snprintf(path, sizeof(path), "%s/perf-%d.map", perf_map_dir_, pid);
+  perf_map_fd_ = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (perf_map_fd_ == -1) {
+    ERROR_LOG("[perf map] can't open %s", path);
+    return false;
+  }
+  perf_map_pid_ = pid;
+
+  if (perf_map_records_) {
+    for (auto &record : *perf_map_records_)
+      write_record(&record);
+  }
+  return true;
+}
+
+PUBLIC void dobby_enable_perf_map(const char *dir) {
+  if (dir == nullptr) {
+#if defined(__ANDROID__)
+    dir = "/data/local/tmp";
+#else
+    dir = "/tmp";
+#endif
+  }
+
+  pthread_mutex_lock(&perf_map_lock_);
+  snprintf(perf_map_dir_, sizeof(perf_map_dir_), "%s", dir);
+  if (perf_map_fd_ != -1) {
+    close(perf_map_fd_);
+    perf_map_fd_ = -1;
+  }
+  __atomic_store_n(&perf_map_enabled_, open_perf_map(), __ATOMIC_RELAXED);
+  pthread_mutex_unlock(&perf_map_lock_);
+}
+
+PUBLIC void dobby_disable_perf_map() {
+  pthread_mutex_lock(&perf_map_lock_);
+  __atomic_store_n(&perf_map_enabled_, false, __ATOMIC_RELAXED);
+  if (perf_map_fd_ != -1) {
+    close(perf_map_fd_);
+    perf_map_fd_ = -1;
+  }
+  pthread_mutex_unlock(&perf_map_lock_);
+}
+
+static void format_name(char *buffer, size_t buffer_size, const char *kind, addr_t target) {
+  Dl_info info;
+  if (target == 0 || !dladdr((void *)target, &info)) {
+    if (target)
+      snprintf(buffer, buffer_size, "dobby:%s:%lx", kind, (unsigned long)target);
+    else
+      snprintf(buffer, buffer_size, "dobby:%s", kind);
+    return;
+  }
+
+  if (info.dli_sname) {
+    addr_t offset = target - (addr_t)info.dli_saddr;
+    if (offset)
+      snprintf(buffer, buffer_size, "dobby:%s:%s+0x%lx", kind, info.dli_sname, (unsigned long)offset);
+    else
+      snprintf(buffer, buffer_size, "dobby:%s:%s", kind, info.dli_sname);
+    return;
+  }
+
+  const char *image = strrchr(info.dli_fname, '/');
+  image = image ? image + 1 : info.dli_fname;
+  snprintf(buffer, buffer_size, "dobby:%s:%s+0x%lx", kind, image, (unsigned long)(target - (addr_t)info.dli_fbase));
+}
+
+static void retain_record(const PerfMapRecord *record) {
+  if (perf_map_records_ == nullptr)
+    perf_map_records_ = new tinystl::vector<PerfMapRecord>();
+  if (perf_map_records_->size() < PERF_MAP_RECORDS_MAX)
+    perf_map_records_->push_back(*record);
+  else
+    (*perf_map_records_)[perf_map_records_next_ % PERF_MAP_RECORDS_MAX] = *record;
+  perf_map_records_next_++;
+}
+
+void PerfMap::Record(addr_t addr, size_t size, const char *kind, addr_t target) {
+  // no dladdr or lock on the hook path unless enabled
+  if (!__atomic_load_n(&perf_map_enabled_, __ATOMIC_RELAXED))
+    return;
+
+  PerfMapRecord record;
+  record.addr = addr;
+  record.size = size;
+  format_name(record.name, sizeof(record.name), kind, target);
+
+  pthread_mutex_lock(&perf_map_lock_);
+  if (perf_map_enabled_ && open_perf_map()) {
+    write_record(&record);
+    retain_record(&record);
+  }
+  pthread_mutex_unlock(&perf_map_lock_);
+}
+
+#else
+
+PUBLIC void dobby_enable_perf_map(const char *dir) {
+}
+
+PUBLIC void dobby_disable_perf_map() {
+}
+
+void PerfMap::Record(addr_t addr, size_t size, const char *kind, addr_t target) {
+}
+
+#endif
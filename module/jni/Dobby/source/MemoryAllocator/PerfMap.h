@@ -0,0 +1,9 @@
+#pragma once
+
+#include "dobby/dobby_internal.h"
+
+class PerfMap {
+public:
+  // name realized code as dobby:<kind>, or dobby:<kind>:<symbol> of the hook target, for the perf map of the process
+  static void Record(addr_t addr, size_t size, const char *kind, addr_t target = 0);
+};
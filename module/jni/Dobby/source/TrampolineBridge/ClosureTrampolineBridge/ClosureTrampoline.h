@@ -36,4 +36,21 @@ private:
 
 public:
   static ClosureTrampolineEntry *CreateClosureTrampoline(void *carry_data, void *carry_handler);
+
+  // instrument bridge saving only the registers in register_mask, calls handler(address, ctx) then branches to
+  // *next_hop, nullptr if the architecture has none
+  static ClosureTrampolineEntry *CreateInstrumentBridge(void *address, void *handler, addr_t *next_hop,
+                                                        uint64_t register_mask);
+
+  // bridge atomically incrementing *counter without a register context, it ends with its next hop literal which is
+  // written once the prologue is relocated. nullptr if the architecture has none
+  static ClosureTrampolineEntry *CreateCounterBridge(uint64_t *counter);
+
+  // bridge entering sampled_target once every every_nth calls, counted down in *countdown, and jumping to its next hop
+  // literal otherwise, written as for the counter bridge. nullptr if the architecture has none
+  static ClosureTrampolineEntry *CreateSamplerBridge(int32_t *countdown, uint32_t every_nth, void *sampled_target);
+
+  // bridge jumping to *next_hop, loaded at every call so the next hop is retargeted with a single store. nullptr if
+  // the architecture has none
+  static ClosureTrampolineEntry *CreateForwardBridge(addr_t *next_hop);
 };
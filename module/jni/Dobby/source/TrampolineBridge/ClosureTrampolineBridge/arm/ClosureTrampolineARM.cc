@@ -34,7 +34,7 @@ ClosureTrampolineEntry *ClosureTrampoline::CreateClosureTrampoline(void *carry_d
   _ PseudoBind(&forward_bridge_label);
   _ EmitAddress((uint32_t)(uintptr_t)get_closure_bridge());
 
-  auto closure_tramp = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_);
+  auto closure_tramp = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_, "closure_trampoline");
   tramp_entry->address = (void *)closure_tramp->addr;
   tramp_entry->size = closure_tramp->size;
   tramp_entry->carry_data = carry_data;
@@ -46,4 +46,51 @@ ClosureTrampolineEntry *ClosureTrampoline::CreateClosureTrampoline(void *carry_d
 #endif
 }
 
-#endif
\ No newline at end of file
+ClosureTrampolineEntry *ClosureTrampoline::CreateInstrumentBridge(void *, void *, addr_t *, uint64_t) {
+  // only Arm64 has specialized bridges, the caller falls back to the closure trampoline
+  return nullptr;
+}
+
+ClosureTrampolineEntry *ClosureTrampoline::CreateCounterBridge(uint64_t *) {
+  // the caller counts in the closure bridge dispatch instead
+  return nullptr;
+}
+
+ClosureTrampolineEntry *ClosureTrampoline::CreateSamplerBridge(int32_t *, uint32_t, void *) {
+  // the caller counts down in the closure bridge dispatch instead
+  return nullptr;
+}
+
+// forward bridge, r12 is clobbered as by the closure trampoline itself
+ClosureTrampolineEntry *ClosureTrampoline::CreateForwardBridge(addr_t *next_hop) {
+#define _ turbo_assembler_.
+  TurboAssembler turbo_assembler_(0);
+
+  AssemblerPseudoLabel next_hop_label(0);
+
+  // the calls taking a new next hop see what was stored before it, bx keeps the thumb bit
+  _ Ldr(r12, &next_hop_label);
+  _ ldr(r12, MemOperand(r12, 0));
+  _ EmitARMInst(0xf57ff05b); // dmb ish
+  _ EmitARMInst(0xe12fff1c); // bx r12
+
+  _ PseudoBind(&next_hop_label);
+  _ EmitAddress((uint32_t)(uintptr_t)next_hop);
+
+  auto bridge = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_, "forward_bridge");
+  if (bridge == nullptr)
+    return nullptr;
+
+  auto tramp_entry = new ClosureTrampolineEntry;
+  tramp_entry->address = (void *)bridge->addr;
+  tramp_entry->size = bridge->size;
+  tramp_entry->carry_data = next_hop;
+  tramp_entry->carry_handler = nullptr;
+
+  delete bridge;
+
+  DEBUG_LOG("[forward bridge] bridge at %p, next hop %p", tramp_entry->address, next_hop);
+  return tramp_entry;
+}
+
+#endif
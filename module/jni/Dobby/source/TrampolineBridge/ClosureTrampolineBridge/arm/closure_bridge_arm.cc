@@ -79,7 +79,7 @@ asm_func_t get_closure_bridge() {
   // auto switch A32 & T32 with `least significant bit`, refer `docs/A32_T32_states_switch.md`
   _ mov(pc, Operand(r12));
 
-  auto code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_);
+  auto code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_, "closure_bridge");
   closure_bridge = (asm_func_t)code->addr;
 
   DEBUG_LOG("[closure bridge] closure bridge at %p", closure_bridge);
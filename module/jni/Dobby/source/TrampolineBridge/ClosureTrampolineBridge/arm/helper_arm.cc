@@ -10,4 +10,16 @@ void set_routing_bridge_next_hop(DobbyRegisterContext *ctx, void *address) {
 void get_routing_bridge_next_hop(DobbyRegisterContext *ctx, void *address) {
 }
 
+void *get_func_ret_address(DobbyRegisterContext *ctx) {
+  return (void *)ctx->lr;
+}
+
+void set_func_ret_address(DobbyRegisterContext *ctx, void *address) {
+  ctx->lr = (uint32_t)(uintptr_t)address;
+}
+
+addr_t get_func_ret_sp(DobbyRegisterContext *ctx, bool) {
+  return ctx->sp;
+}
+
 #endif
\ No newline at end of file
@@ -48,7 +48,7 @@ ClosureTrampolineEntry *ClosureTrampoline::CreateClosureTrampoline(void *carry_d
   _ PseudoBind(&forward_bridge_label);
   _ EmitInt64((uint64_t)get_closure_bridge());
 
-  auto closure_tramp = AssemblyCodeBuilder::FinalizeFromTurboAssembler(static_cast<AssemblerBase *>(&turbo_assembler_));
+  auto closure_tramp = AssemblyCodeBuilder::FinalizeFromTurboAssembler(static_cast<AssemblerBase *>(&turbo_assembler_), "closure_trampoline");
 
   tramp_entry->address = (void *)closure_tramp->addr;
   tramp_entry->size = closure_tramp->size;
@@ -60,4 +60,232 @@ ClosureTrampolineEntry *ClosureTrampoline::CreateClosureTrampoline(void *carry_d
   return tramp_entry;
 }
 
+// DobbyRegisterContext offsets, see closure_bridge_arm64.cc
+#define CTX_SP_OFFSET 8
+#define CTX_X_OFFSET(n) (24 + (n)*8)
+#define CTX_Q_OFFSET(n) (CTX_X_OFFSET(31) + (n)*16)
+
+// bridge specialized for one instrument point, saves only the registers in register_mask, calls the handler
+// directly instead of common_closure_bridge_handler, then branches to *next_hop
+ClosureTrampolineEntry *ClosureTrampoline::CreateInstrumentBridge(void *address, void *handler, addr_t *next_hop,
+                                                                  uint64_t register_mask) {
+  uint32_t x_mask = (uint32_t)register_mask;
+  uint32_t q_mask = (uint32_t)(register_mask >> 32);
+
+  // context only as large as the highest saved q register
+  int context_size = CTX_Q_OFFSET(0);
+  for (int i = 0; i < 32; i += 2) {
+    if (q_mask & (0b11u << i))
+      context_size = CTX_Q_OFFSET(i + 2);
+  }
+  context_size = ALIGN_CEIL(context_size, 16);
+
+#define _ turbo_assembler_.
+#define MEM(reg, offset) MemOperand(reg, offset)
+  TurboAssembler turbo_assembler_(0);
+
+  AssemblerPseudoLabel address_label(0);
+  AssemblerPseudoLabel handler_label(0);
+  AssemblerPseudoLabel next_hop_label(0);
+
+  _ sub(SP, SP, context_size);
+
+  // save the masked {x0-x28} in pairs, {x29, x30} are always saved, lr is clobbered by the call
+  for (int i = 0; i < 28; i += 2) {
+    if (x_mask & (0b11u << i))
+      _ stp(X(i), X(i + 1), MEM(SP, CTX_X_OFFSET(i)));
+  }
+  if (x_mask & (1u << 28))
+    _ str(X(28), MEM(SP, CTX_X_OFFSET(28)));
+  _ stp(X(29), X(30), MEM(SP, CTX_X_OFFSET(29)));
+
+  // save the masked {q0-q31} in pairs
+  for (int i = 0; i < 32; i += 2) {
+    if (q_mask & (0b11u << i))
+      _ stp(Q(i), Q(i + 1), MEM(SP, CTX_Q_OFFSET(i)));
+  }
+
+  // original sp
+  _ add(TMP_REG_0, SP, context_size);
+  _ str(TMP_REG_0, MEM(SP, CTX_SP_OFFSET));
+
+  // handler(address, ctx)
+  _ Ldr(x0, &address_label);
+  _ mov(x1, SP);
+  _ Ldr(TMP_REG_0, &handler_label);
+  _ blr(TMP_REG_0);
+
+  for (int i = 0; i < 28; i += 2) {
+    if (x_mask & (0b11u << i))
+      _ ldp(X(i), X(i + 1), MEM(SP, CTX_X_OFFSET(i)));
+  }
+  if (x_mask & (1u << 28))
+    _ ldr(X(28), MEM(SP, CTX_X_OFFSET(28)));
+  _ ldp(X(29), X(30), MEM(SP, CTX_X_OFFSET(29)));
+
+  for (int i = 0; i < 32; i += 2) {
+    if (q_mask & (0b11u << i))
+      _ ldp(Q(i), Q(i + 1), MEM(SP, CTX_Q_OFFSET(i)));
+  }
+
+  _ add(SP, SP, context_size);
+
+  // branch to next hop, read at every hit as it's only known after relocation
+  _ Ldr(TMP_REG_0, &next_hop_label);
+  _ ldr(TMP_REG_0, MEM(TMP_REG_0, 0));
+  _ br(TMP_REG_0);
+
+  _ PseudoBind(&address_label);
+  _ EmitInt64((uint64_t)address);
+  _ PseudoBind(&handler_label);
+  _ EmitInt64((uint64_t)handler);
+  _ PseudoBind(&next_hop_label);
+  _ EmitInt64((uint64_t)next_hop);
+
+  auto bridge = AssemblyCodeBuilder::FinalizeFromTurboAssembler(static_cast<AssemblerBase *>(&turbo_assembler_), "instrument_bridge", (addr_t)address);
+  if (bridge == nullptr)
+    return nullptr;
+
+  auto tramp_entry = new ClosureTrampolineEntry;
+  tramp_entry->address = (void *)bridge->addr;
+  tramp_entry->size = bridge->size;
+  tramp_entry->carry_data = address;
+  tramp_entry->carry_handler = handler;
+
+  delete bridge;
+
+  DEBUG_LOG("[instrument bridge] bridge at %p, register mask 0x%llx", tramp_entry->address, register_mask);
+  return tramp_entry;
+}
+
+// hit counter bridge, x15 and x16 are restored, x17 is clobbered as by the trampoline itself
+ClosureTrampolineEntry *ClosureTrampoline::CreateCounterBridge(uint64_t *counter) {
+#define _ turbo_assembler_.
+  TurboAssembler turbo_assembler_(0);
+
+  AssemblerPseudoLabel counter_label(0);
+  AssemblerPseudoLabel next_hop_label(0);
+
+  _ stp(X(15), X(16), MemOperand(SP, -16, PreIndex));
+  _ Ldr(X(16), &counter_label);
+
+  // retry: ldxr x17, [x16]; add x17, x17, #1; stxr w15, x17, [x16]; cbnz w15, retry
+  _ Emit(0xc85f7e11);
+  _ add(X(17), X(17), 1);
+  _ Emit(0xc80f7e11);
+  _ Emit(0x35ffffaf);
+
+  _ ldp(X(15), X(16), MemOperand(SP, 16, PostIndex));
+  _ Ldr(TMP_REG_0, &next_hop_label);
+  _ br(TMP_REG_0);
+
+  _ PseudoBind(&counter_label);
+  _ EmitInt64((uint64_t)counter);
+  _ PseudoBind(&next_hop_label);
+  _ EmitInt64(0);
+
+  auto bridge = AssemblyCodeBuilder::FinalizeFromTurboAssembler(static_cast<AssemblerBase *>(&turbo_assembler_), "counter_bridge");
+  if (bridge == nullptr)
+    return nullptr;
+
+  auto tramp_entry = new ClosureTrampolineEntry;
+  tramp_entry->address = (void *)bridge->addr;
+  tramp_entry->size = bridge->size;
+  tramp_entry->carry_data = counter;
+  tramp_entry->carry_handler = nullptr;
+
+  delete bridge;
+
+  DEBUG_LOG("[counter bridge] bridge at %p, counter %p", tramp_entry->address, counter);
+  return tramp_entry;
+}
+
+// sampling bridge, counts down *countdown with a plain load and store, a racing thread only shifts the sample. On
+// reaching zero (or below, after a race) it reloads every_nth and enters sampled_target, otherwise it jumps to its next
+// hop literal, written once the prologue is relocated
+ClosureTrampolineEntry *ClosureTrampoline::CreateSamplerBridge(int32_t *countdown, uint32_t every_nth,
+                                                               void *sampled_target) {
+#define _ turbo_assembler_.
+  TurboAssembler turbo_assembler_(0);
+
+  AssemblerPseudoLabel countdown_label(0);
+  AssemblerPseudoLabel sampled_label(0);
+  AssemblerPseudoLabel next_hop_label(0);
+
+  _ stp(X(15), X(16), MemOperand(SP, -16, PreIndex));
+  _ Ldr(X(16), &countdown_label);
+  // ldr w15, [x16]; sub w15, w15, #1; str w15, [x16]
+  _ Emit(0xb940020f);
+  _ sub(W(15), W(15), 1);
+  _ Emit(0xb900020f);
+  // cbz w15, sample; tbnz w15, #31, sample, no flags are touched
+  _ Emit(0x340000af);
+  _ Emit(0x37f8008f);
+
+  _ ldp(X(15), X(16), MemOperand(SP, 16, PostIndex));
+  _ Ldr(TMP_REG_0, &next_hop_label);
+  _ br(TMP_REG_0);
+
+  // sample: reload the countdown and enter the closure bridge
+  _ movz(W(15), every_nth & 0xffff, 0);
+  _ movk(W(15), (every_nth >> 16) & 0xffff, 16);
+  _ Emit(0xb900020f);
+  _ ldp(X(15), X(16), MemOperand(SP, 16, PostIndex));
+  _ Ldr(TMP_REG_0, &sampled_label);
+  _ br(TMP_REG_0);
+
+  _ PseudoBind(&countdown_label);
+  _ EmitInt64((uint64_t)countdown);
+  _ PseudoBind(&sampled_label);
+  _ EmitInt64((uint64_t)sampled_target);
+  _ PseudoBind(&next_hop_label);
+  _ EmitInt64(0);
+
+  auto bridge = AssemblyCodeBuilder::FinalizeFromTurboAssembler(static_cast<AssemblerBase *>(&turbo_assembler_), "sampler_bridge");
+  if (bridge == nullptr)
+    return nullptr;
+
+  auto tramp_entry = new ClosureTrampolineEntry;
+  tramp_entry->address = (void *)bridge->addr;
+  tramp_entry->size = bridge->size;
+  tramp_entry->carry_data = countdown;
+  tramp_entry->carry_handler = sampled_target;
+
+  delete bridge;
+
+  DEBUG_LOG("[sampler bridge] bridge at %p, every %u calls", tramp_entry->address, every_nth);
+  return tramp_entry;
+}
+
+// forward bridge, x17 is clobbered as by the trampoline itself
+ClosureTrampolineEntry *ClosureTrampoline::CreateForwardBridge(addr_t *next_hop) {
+#define _ turbo_assembler_.
+  TurboAssembler turbo_assembler_(0);
+
+  AssemblerPseudoLabel next_hop_label(0);
+
+  // ldar x17, [x17], the calls taking a new next hop see what was stored before it
+  _ Ldr(TMP_REG_0, &next_hop_label);
+  _ Emit(0xc8dffe31);
+  _ br(TMP_REG_0);
+
+  _ PseudoBind(&next_hop_label);
+  _ EmitInt64((uint64_t)next_hop);
+
+  auto bridge = AssemblyCodeBuilder::FinalizeFromTurboAssembler(static_cast<AssemblerBase *>(&turbo_assembler_), "forward_bridge");
+  if (bridge == nullptr)
+    return nullptr;
+
+  auto tramp_entry = new ClosureTrampolineEntry;
+  tramp_entry->address = (void *)bridge->addr;
+  tramp_entry->size = bridge->size;
+  tramp_entry->carry_data = next_hop;
+  tramp_entry->carry_handler = nullptr;
+
+  delete bridge;
+
+  DEBUG_LOG("[forward bridge] bridge at %p, next hop %p", tramp_entry->address, next_hop);
+  return tramp_entry;
+}
+
 #endif
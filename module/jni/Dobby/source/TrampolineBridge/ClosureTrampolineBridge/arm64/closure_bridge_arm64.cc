@@ -148,7 +148,7 @@ asm_func_t get_closure_bridge() {
   // return to closure trampoline, but TMP_REG_0, had been modified with next hop address
   _ ret(); // AKA br x30
 
-  auto code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_);
+  auto code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_, "closure_bridge");
   closure_bridge = (asm_func_t)code->addr;
 
   DEBUG_LOG("[closure bridge] closure bridge at %p", closure_bridge);
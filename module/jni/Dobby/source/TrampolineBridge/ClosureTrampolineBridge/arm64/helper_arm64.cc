@@ -14,4 +14,17 @@ void set_routing_bridge_next_hop(DobbyRegisterContext *ctx, void *address) {
 void get_routing_bridge_next_hop(DobbyRegisterContext *ctx, void *address) {
 }
 
+// the closure trampoline spills lr below the original sp, and reloads it after the bridge
+void *get_func_ret_address(DobbyRegisterContext *ctx) {
+  return *reinterpret_cast<void **>(ctx->sp - 8);
+}
+
+void set_func_ret_address(DobbyRegisterContext *ctx, void *address) {
+  *reinterpret_cast<void **>(ctx->sp - 8) = address;
+}
+
+addr_t get_func_ret_sp(DobbyRegisterContext *ctx, bool) {
+  return ctx->sp;
+}
+
 #endif
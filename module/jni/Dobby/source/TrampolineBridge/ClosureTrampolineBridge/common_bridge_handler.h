@@ -14,4 +14,12 @@ void get_routing_bridge_next_hop(DobbyRegisterContext *ctx, void *address);
 
 void set_routing_bridge_next_hop(DobbyRegisterContext *ctx, void *address);
 
+// return address of the function entered at the bridge
+void *get_func_ret_address(DobbyRegisterContext *ctx);
+
+void set_func_ret_address(DobbyRegisterContext *ctx, void *address);
+
+// caller stack pointer once the function returns, computed at the function entry or at its return
+addr_t get_func_ret_sp(DobbyRegisterContext *ctx, bool at_entry);
+
 #endif
\ No newline at end of file
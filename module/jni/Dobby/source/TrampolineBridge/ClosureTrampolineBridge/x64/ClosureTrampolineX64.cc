@@ -7,6 +7,8 @@
 
 #include "TrampolineBridge/ClosureTrampolineBridge/ClosureTrampoline.h"
 
+#include "MemoryAllocator/PerfMap.h"
+
 using namespace zz;
 using namespace zz::x64;
 
@@ -38,8 +40,121 @@ ClosureTrampolineEntry *ClosureTrampoline::CreateClosureTrampoline(void *carry_d
 
   auto closure_tramp_buffer = static_cast<CodeBufferBase *>(turbo_assembler_.GetCodeBuffer());
   DobbyCodePatch(tramp_mem, (uint8_t *)closure_tramp_buffer->GetBuffer(), closure_tramp_buffer->GetBufferSize());
+  PerfMap::Record((addr_t)tramp_mem, closure_tramp_buffer->GetBufferSize(), "closure_trampoline");
+
+  return tramp_entry;
+}
+
+ClosureTrampolineEntry *ClosureTrampoline::CreateInstrumentBridge(void *, void *, addr_t *, uint64_t) {
+  // only Arm64 has specialized bridges, the caller falls back to the closure trampoline
+  return nullptr;
+}
+
+// hit counter bridge, keeps every register and the flags (lahf and seto, cheaper than pushfq), steps over the red
+// zone as it may be mid function
+ClosureTrampolineEntry *ClosureTrampoline::CreateCounterBridge(uint64_t *counter) {
+#define _ turbo_assembler_.
+#define __ turbo_assembler_.GetCodeBuffer()->
+  TurboAssembler turbo_assembler_(0);
+
+  // lea rsp, [rsp - 128]; push rax; lahf; seto al; push rcx
+  __ EmitBuffer((uint8_t *)"\x48\x8d\x64\x24\x80\x50\x9f\x0f\x90\xc0\x51", 11);
+  // mov rcx, counter
+  __ EmitBuffer((uint8_t *)"\x48\xb9", 2);
+  __ Emit64((uint64_t)counter);
+  // lock inc qword ptr [rcx]
+  __ EmitBuffer((uint8_t *)"\xf0\x48\xff\x01", 4);
+  // pop rcx; add al, 0x7f; sahf; pop rax; lea rsp, [rsp + 128]
+  __ EmitBuffer((uint8_t *)"\x59\x04\x7f\x9e\x58\x48\x8d\xa4\x24\x80\x00\x00\x00", 13);
+  // jmp [rip + 0]
+  __ EmitBuffer((uint8_t *)"\xff\x25\x00\x00\x00\x00", 6);
+  __ Emit64(0);
+
+  auto bridge = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_, "counter_bridge");
+  if (bridge == nullptr)
+    return nullptr;
+
+  auto tramp_entry = new ClosureTrampolineEntry;
+  tramp_entry->address = (void *)bridge->addr;
+  tramp_entry->size = bridge->size;
+  tramp_entry->carry_data = counter;
+  tramp_entry->carry_handler = nullptr;
+
+  delete bridge;
+
+  DEBUG_LOG("[counter bridge] bridge at %p, counter %p", tramp_entry->address, counter);
+  return tramp_entry;
+}
+
+// sampling bridge, counts down *countdown without a lock prefix, a racing thread only shifts the sample. On reaching
+// zero (or below, after a race) it reloads every_nth and enters sampled_target, otherwise it jumps to its next hop
+// literal. Keeps the flags as the counter bridge does
+ClosureTrampolineEntry *ClosureTrampoline::CreateSamplerBridge(int32_t *countdown, uint32_t every_nth,
+                                                               void *sampled_target) {
+#define _ turbo_assembler_.
+#define __ turbo_assembler_.GetCodeBuffer()->
+  TurboAssembler turbo_assembler_(0);
+
+  // lea rsp, [rsp - 128]; push rax; lahf; seto al; push rcx
+  __ EmitBuffer((uint8_t *)"\x48\x8d\x64\x24\x80\x50\x9f\x0f\x90\xc0\x51", 11);
+  // mov rcx, countdown
+  __ EmitBuffer((uint8_t *)"\x48\xb9", 2);
+  __ Emit64((uint64_t)countdown);
+  // sub dword ptr [rcx], 1; jg skip
+  __ EmitBuffer((uint8_t *)"\x83\x29\x01\x7f\x21", 5);
+  // mov dword ptr [rcx], every_nth
+  __ EmitBuffer((uint8_t *)"\xc7\x01", 2);
+  __ Emit32(every_nth);
+  // pop rcx; add al, 0x7f; sahf; pop rax; lea rsp, [rsp + 128]; jmp [rip + 0]
+  __ EmitBuffer((uint8_t *)"\x59\x04\x7f\x9e\x58\x48\x8d\xa4\x24\x80\x00\x00\x00", 13);
+  __ EmitBuffer((uint8_t *)"\xff\x25\x00\x00\x00\x00", 6);
+  __ Emit64((uint64_t)sampled_target);
+  // skip: same restore, jmp [rip + 0] to the next hop
+  __ EmitBuffer((uint8_t *)"\x59\x04\x7f\x9e\x58\x48\x8d\xa4\x24\x80\x00\x00\x00", 13);
+  __ EmitBuffer((uint8_t *)"\xff\x25\x00\x00\x00\x00", 6);
+  __ Emit64(0);
+
+  auto bridge = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_, "sampler_bridge");
+  if (bridge == nullptr)
+    return nullptr;
+
+  auto tramp_entry = new ClosureTrampolineEntry;
+  tramp_entry->address = (void *)bridge->addr;
+  tramp_entry->size = bridge->size;
+  tramp_entry->carry_data = countdown;
+  tramp_entry->carry_handler = sampled_target;
+
+  delete bridge;
+
+  DEBUG_LOG("[sampler bridge] bridge at %p, every %u calls", tramp_entry->address, every_nth);
+  return tramp_entry;
+}
+
+// forward bridge, r11 is clobbered as x17 by the Arm64 one, it's neither an argument nor callee saved
+ClosureTrampolineEntry *ClosureTrampoline::CreateForwardBridge(addr_t *next_hop) {
+#define _ turbo_assembler_.
+#define __ turbo_assembler_.GetCodeBuffer()->
+  TurboAssembler turbo_assembler_(0);
+
+  // mov r11, next_hop; jmp [r11]
+  __ EmitBuffer((uint8_t *)"\x49\xbb", 2);
+  __ Emit64((uint64_t)next_hop);
+  __ EmitBuffer((uint8_t *)"\x41\xff\x23", 3);
+
+  auto bridge = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_, "forward_bridge");
+  if (bridge == nullptr)
+    return nullptr;
+
+  auto tramp_entry = new ClosureTrampolineEntry;
+  tramp_entry->address = (void *)bridge->addr;
+  tramp_entry->size = bridge->size;
+  tramp_entry->carry_data = next_hop;
+  tramp_entry->carry_handler = nullptr;
+
+  delete bridge;
 
+  DEBUG_LOG("[forward bridge] bridge at %p, next hop %p", tramp_entry->address, next_hop);
   return tramp_entry;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -14,4 +14,17 @@ void set_routing_bridge_next_hop(DobbyRegisterContext *ctx, void *address) {
 void get_routing_bridge_next_hop(DobbyRegisterContext *ctx, void *address) {
 }
 
+void *get_func_ret_address(DobbyRegisterContext *ctx) {
+  return *(void **)ctx->rsp;
+}
+
+void set_func_ret_address(DobbyRegisterContext *ctx, void *address) {
+  *(void **)ctx->rsp = address;
+}
+
+addr_t get_func_ret_sp(DobbyRegisterContext *ctx, bool at_entry) {
+  // ret pops the return address
+  return at_entry ? ctx->rsp + 8 : ctx->rsp;
+}
+
 #endif
\ No newline at end of file
@@ -7,6 +7,8 @@
 
 #include "TrampolineBridge/ClosureTrampolineBridge/ClosureTrampoline.h"
 
+#include "MemoryAllocator/PerfMap.h"
+
 using namespace zz;
 using namespace zz::x86;
 
@@ -37,8 +39,50 @@ ClosureTrampolineEntry *ClosureTrampoline::CreateClosureTrampoline(void *carry_d
 
   auto closure_tramp_buffer = static_cast<CodeBufferBase *>(turbo_assembler_.GetCodeBuffer());
   DobbyCodePatch(tramp_mem, (uint8_t *)closure_tramp_buffer->GetBuffer(), closure_tramp_buffer->GetBufferSize());
+  PerfMap::Record((addr_t)tramp_mem, closure_tramp_buffer->GetBufferSize(), "closure_trampoline");
+
+  return tramp_entry;
+}
+
+ClosureTrampolineEntry *ClosureTrampoline::CreateInstrumentBridge(void *, void *, addr_t *, uint64_t) {
+  // only Arm64 has specialized bridges, the caller falls back to the closure trampoline
+  return nullptr;
+}
+
+ClosureTrampolineEntry *ClosureTrampoline::CreateCounterBridge(uint64_t *) {
+  // the caller counts in the closure bridge dispatch instead
+  return nullptr;
+}
+
+ClosureTrampolineEntry *ClosureTrampoline::CreateSamplerBridge(int32_t *, uint32_t, void *) {
+  // the caller counts down in the closure bridge dispatch instead
+  return nullptr;
+}
+
+// forward bridge, no register is clobbered
+ClosureTrampolineEntry *ClosureTrampoline::CreateForwardBridge(addr_t *next_hop) {
+#define _ turbo_assembler_.
+#define __ turbo_assembler_.GetCodeBuffer()->
+  TurboAssembler turbo_assembler_(0);
+
+  // jmp [next_hop]
+  __ EmitBuffer((uint8_t *)"\xff\x25", 2);
+  __ Emit32((uint32_t)(uintptr_t)next_hop);
+
+  auto bridge = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_, "forward_bridge");
+  if (bridge == nullptr)
+    return nullptr;
+
+  auto tramp_entry = new ClosureTrampolineEntry;
+  tramp_entry->address = (void *)bridge->addr;
+  tramp_entry->size = bridge->size;
+  tramp_entry->carry_data = next_hop;
+  tramp_entry->carry_handler = nullptr;
+
+  delete bridge;
 
+  DEBUG_LOG("[forward bridge] bridge at %p, next hop %p", tramp_entry->address, next_hop);
   return tramp_entry;
 }
 
-#endif
\ No newline at end of file
+#endif
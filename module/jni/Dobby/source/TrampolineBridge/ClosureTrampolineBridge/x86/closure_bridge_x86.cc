@@ -101,7 +101,7 @@ asm_func_t get_closure_bridge() {
 
   _ RelocBind();
 
-  auto code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_);
+  auto code = AssemblyCodeBuilder::FinalizeFromTurboAssembler(&turbo_assembler_, "closure_bridge");
   closure_bridge = (asm_func_t)code->addr;
 
   DEBUG_LOG("[closure bridge]  closure bridge at %p", closure_bridge);
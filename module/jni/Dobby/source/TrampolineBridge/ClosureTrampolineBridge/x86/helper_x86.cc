@@ -13,4 +13,17 @@ void set_routing_bridge_next_hop(DobbyRegisterContext *ctx, void *address) {
 void get_routing_bridge_next_hop(DobbyRegisterContext *ctx, void *address) {
 }
 
+void *get_func_ret_address(DobbyRegisterContext *ctx) {
+  return *(void **)ctx->esp;
+}
+
+void set_func_ret_address(DobbyRegisterContext *ctx, void *address) {
+  *(void **)ctx->esp = address;
+}
+
+addr_t get_func_ret_sp(DobbyRegisterContext *ctx, bool at_entry) {
+  // ret pops the return address, callee-pop returns release more
+  return at_entry ? ctx->esp + 4 : ctx->esp;
+}
+
 #endif
\ No newline at end of file
@@ -2,4 +2,5 @@
 
 #include "MemoryAllocator/AssemblyCodeBuilder.h"
 
-CodeBufferBase *GenerateNormalTrampolineBuffer(addr_t from, addr_t to);
\ No newline at end of file
+// write the absolute branch from `from` to `to` into buffer
+bool GenerateNormalTrampolineBuffer(addr_t from, addr_t to, CodeBufferBase *buffer);
\ No newline at end of file
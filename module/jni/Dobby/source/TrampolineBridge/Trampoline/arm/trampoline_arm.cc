@@ -13,17 +13,17 @@
 
 using namespace zz::arm;
 
-static CodeBufferBase *generate_arm_trampoline(addr32_t from, addr32_t to) {
+static void generate_arm_trampoline(addr32_t from, addr32_t to, CodeBufferBase *buffer) {
   TurboAssembler turbo_assembler_((void *)from);
 #define _ turbo_assembler_.
 
   CodeGen codegen(&turbo_assembler_);
   codegen.LiteralLdrBranch(to);
 
-  return turbo_assembler_.GetCodeBuffer()->Copy();
+  buffer->CopyFrom(turbo_assembler_.GetCodeBuffer());
 }
 
-CodeBufferBase *generate_thumb_trampoline(addr32_t from, addr32_t to) {
+void generate_thumb_trampoline(addr32_t from, addr32_t to, CodeBufferBase *buffer) {
   ThumbTurboAssembler thumb_turbo_assembler_((void *)from);
 #undef _
 #define _ thumb_turbo_assembler_.
@@ -32,10 +32,10 @@ CodeBufferBase *generate_thumb_trampoline(addr32_t from, addr32_t to) {
   _ t2_ldr(pc, MemOperand(pc, 0));
   _ EmitAddress(to);
 
-  return thumb_turbo_assembler_.GetCodeBuffer()->Copy();
+  buffer->CopyFrom(thumb_turbo_assembler_.GetCodeBuffer());
 }
 
-CodeBufferBase *GenerateNormalTrampolineBuffer(addr_t from, addr_t to) {
+bool GenerateNormalTrampolineBuffer(addr_t from, addr_t to, CodeBufferBase *buffer) {
   enum ExecuteState { ARMExecuteState, ThumbExecuteState };
 
   // set instruction running state
@@ -46,17 +46,17 @@ CodeBufferBase *GenerateNormalTrampolineBuffer(addr_t from, addr_t to) {
   }
 
   if (execute_state_ == ARMExecuteState) {
-    return generate_arm_trampoline(from, to);
+    generate_arm_trampoline(from, to, buffer);
   } else {
     // Check if needed pc align, (relative pc instructions needed 4 align)
     from = from - THUMB_ADDRESS_FLAG;
-    return generate_thumb_trampoline(from, to);
+    generate_thumb_trampoline(from, to, buffer);
   }
-  return NULL;
+  return true;
 }
 
-CodeBufferBase *GenerateNearTrampolineBuffer(InterceptRouting *routing, addr_t src, addr_t dst) {
-  return NULL;
+bool GenerateNearTrampolineBuffer(InterceptRouting *routing, addr_t src, addr_t dst, CodeBufferBase *) {
+  return false;
 }
 
 #endif
\ No newline at end of file
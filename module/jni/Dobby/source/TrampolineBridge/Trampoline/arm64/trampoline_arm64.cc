@@ -12,7 +12,7 @@
 
 using namespace zz::arm64;
 
-CodeBufferBase *GenerateNormalTrampolineBuffer(addr_t from, addr_t to) {
+bool GenerateNormalTrampolineBuffer(addr_t from, addr_t to, CodeBufferBase *buffer) {
   TurboAssembler turbo_assembler_((void *)from);
 #define _ turbo_assembler_.
 
@@ -34,8 +34,8 @@ CodeBufferBase *GenerateNormalTrampolineBuffer(addr_t from, addr_t to) {
   // Bind all labels
   turbo_assembler_.RelocBind();
 
-  auto result = turbo_assembler_.GetCodeBuffer()->Copy();
-  return result;
+  buffer->CopyFrom(turbo_assembler_.GetCodeBuffer());
+  return true;
 }
 
 #endif
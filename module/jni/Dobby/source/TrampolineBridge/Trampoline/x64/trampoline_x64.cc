@@ -27,7 +27,7 @@ static addr_t allocate_indirect_stub(addr_t jmp_insn_addr) {
   return stub_addr;
 }
 
-CodeBufferBase *GenerateNormalTrampolineBuffer(addr_t from, addr_t to) {
+bool GenerateNormalTrampolineBuffer(addr_t from, addr_t to, CodeBufferBase *buffer) {
   TurboAssembler turbo_assembler_((void *)from);
 #define _ turbo_assembler_.
 
@@ -35,20 +35,20 @@ CodeBufferBase *GenerateNormalTrampolineBuffer(addr_t from, addr_t to) {
   auto jump_near_next_insn_addr = from + 6;
   addr_t forward_stub = allocate_indirect_stub(jump_near_next_insn_addr);
   if (forward_stub == 0)
-    return nullptr;
+    return false;
 
   *(addr_t *)forward_stub = to;
 
   CodeGen codegen(&turbo_assembler_);
   codegen.JmpNearIndirect((addr_t)forward_stub);
 
-  auto buffer = turbo_assembler_.GetCodeBuffer()->Copy();
-  return buffer;
+  buffer->CopyFrom(turbo_assembler_.GetCodeBuffer());
+  return true;
 }
 
-CodeBufferBase *GenerateNearTrampolineBuffer(InterceptRouting *routing, addr_t src, addr_t dst) {
+bool GenerateNearTrampolineBuffer(InterceptRouting *routing, addr_t src, addr_t dst, CodeBufferBase *) {
   DEBUG_LOG("x64 near branch trampoline enable default");
-  return nullptr;
+  return false;
 }
 
 #endif
\ No newline at end of file
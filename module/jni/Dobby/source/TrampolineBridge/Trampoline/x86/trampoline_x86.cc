@@ -13,21 +13,20 @@
 
 using namespace zz::x86;
 
-CodeBufferBase *GenerateNormalTrampolineBuffer(addr_t from, addr_t to) {
+bool GenerateNormalTrampolineBuffer(addr_t from, addr_t to, CodeBufferBase *buffer) {
   TurboAssembler turbo_assembler_((void *)from);
 #define _ turbo_assembler_.
 
   CodeGen codegen(&turbo_assembler_);
   codegen.JmpNear((uint32_t)to);
 
-  CodeBufferBase *result = NULL;
-  result = turbo_assembler_.GetCodeBuffer()->Copy();
-  return result;
+  buffer->CopyFrom(turbo_assembler_.GetCodeBuffer());
+  return true;
 }
 
-CodeBufferBase *GenerateNearTrampolineBuffer(InterceptRouting *routing, addr_t src, addr_t dst) {
+bool GenerateNearTrampolineBuffer(InterceptRouting *routing, addr_t src, addr_t dst, CodeBufferBase *) {
   DEBUG_LOG("x86 near branch trampoline enable default");
-  return NULL;
+  return false;
 }
 
 #endif
\ No newline at end of file
@@ -184,10 +184,12 @@ class Assembler : public AssemblerBase {
 private:
   ExecuteState execute_state_;
 
+  CodeBuffer code_buffer_;
+
 public:
   Assembler(void *address) : AssemblerBase(address) {
     execute_state_ = ARMExecuteState;
-    buffer_ = new CodeBuffer();
+    buffer_ = &code_buffer_;
   }
 
   // shared_ptr is better choice
@@ -269,13 +269,15 @@ private:
 // ---
 
 class Assembler : public AssemblerBase {
+private:
+  CodeBuffer code_buffer_;
+
 public:
   Assembler(void *address) : AssemblerBase(address) {
-    buffer_ = new CodeBuffer();
+    buffer_ = &code_buffer_;
   }
+
   ~Assembler() {
-    if (buffer_)
-      delete buffer_;
     buffer_ = NULL;
   }
 
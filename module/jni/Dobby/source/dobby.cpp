@@ -1,5 +1,6 @@
 #include "dobby/dobby_internal.h"
 #include "Interceptor.h"
+#include "InterceptRouting/Routing/FunctionInlineHook/FunctionInlineHookRouting.h"
 
 __attribute__((constructor)) static void ctor() {
   DEBUG_LOG("================================");
@@ -20,12 +21,103 @@ PUBLIC int DobbyDestroy(void *address) {
 #endif
   auto entry = Interceptor::SharedInstance()->find((addr_t)address);
   if (entry) {
-    uint8_t *buffer = entry->origin_insns;
-    uint32_t buffer_size = entry->origin_insn_size;
-    DobbyCodePatch(address, buffer, buffer_size);
+    // only the latest of chained hooks is removed, the patch site stays for the others
+    if (entry->type == kFunctionInlineHook) {
+      auto routing = static_cast<FunctionInlineHookRouting *>(entry->routing);
+      if (routing->RemoveReplaceCall(routing->GetReplaceCall()))
+        return 0;
+    }
+
+    // a prepared but not committed hook has nothing to restore
+    if (entry->committed) {
+      uint8_t *buffer = entry->origin_insns;
+      uint32_t buffer_size = entry->origin_insn_size;
+      DobbyCodePatch(address, buffer, buffer_size);
+    }
+    entry->routing->ReleaseNearVeneer();
     Interceptor::SharedInstance()->remove((addr_t)address);
     return 0;
   }
 
   return -1;
 }
+
+PUBLIC int DobbyDestroyHook(void *address, dobby_dummy_func_t replace_func) {
+#if defined(TARGET_ARCH_ARM)
+  if ((addr_t)address % 2) {
+    address = (void *)((addr_t)address - 1);
+  }
+#endif
+#if defined(__APPLE__) && defined(__arm64__)
+  replace_func = pac_strip(replace_func);
+#endif
+  auto entry = Interceptor::SharedInstance()->find((addr_t)address);
+  if (!entry || entry->type != kFunctionInlineHook)
+    return -1;
+
+  auto routing = static_cast<FunctionInlineHookRouting *>(entry->routing);
+  auto chain = routing->GetChain();
+  for (uint32_t i = 0; i < chain->count; i++) {
+    if (chain->links[i]->replace_func != replace_func)
+      continue;
+    if (routing->RemoveReplaceCall(replace_func))
+      return 0;
+    // the last hook, restore the patch site
+    return DobbyDestroy(address);
+  }
+
+  ERROR_LOG("%p is not hooked with %p.", address, replace_func);
+  return -1;
+}
+
+PUBLIC int DobbyCommit(void *address) {
+#if defined(TARGET_ARCH_ARM)
+  if ((addr_t)address % 2) {
+    address = (void *)((addr_t)address - 1);
+  }
+#endif
+  auto entry = Interceptor::SharedInstance()->find((addr_t)address);
+  if (!entry) {
+    ERROR_LOG("%p not prepared.", address);
+    return -1;
+  }
+  if (entry->committed)
+    return 0;
+
+  entry->routing->Commit();
+  return entry->committed ? 0 : -1;
+}
+
+PUBLIC int DobbyGetTrampolineKind(void *address, DobbyTrampolineKind *kind, uint32_t *patch_size) {
+#if defined(TARGET_ARCH_ARM)
+  if ((addr_t)address % 2) {
+    address = (void *)((addr_t)address - 1);
+  }
+#endif
+  auto entry = Interceptor::SharedInstance()->find((addr_t)address);
+  if (!entry)
+    return -1;
+
+  if (kind)
+    *kind = entry->trampoline_kind;
+  if (patch_size)
+    *patch_size = entry->patched_size;
+  return 0;
+}
+
+PUBLIC int DobbyGetHookStats(void *address, DobbyHookStats *stats) {
+#if defined(TARGET_ARCH_ARM)
+  if ((addr_t)address % 2) {
+    address = (void *)((addr_t)address - 1);
+  }
+#endif
+  auto entry = Interceptor::SharedInstance()->find((addr_t)address);
+  if (!entry || entry->type != kFunctionInlineHook)
+    return -1;
+
+  auto routing = static_cast<FunctionInlineHookRouting *>(entry->routing);
+  if (routing->stats == nullptr)
+    return -1;
+  hook_stats_aggregate(routing->stats, stats);
+  return 0;
+}
@@ -74,6 +74,9 @@ static void hook_trace_insn(uc_engine *uc, uint64_t address, uint32_t size, void
     return;
   }
 
+  if (!emu->trace_)
+    return;
+
   if ((emu->arch_ == "arm" || emu->arch_ == "thumb") && emu->isThumb()) {
     CapstoneDisassembler::Get("thumb")->disassemble(address, (char *)insn_bytes, size);
   } else {
@@ -82,8 +85,9 @@ static void hook_trace_insn(uc_engine *uc, uint64_t address, uint32_t size, void
 }
 
 static void hook_unmapped(uc_engine *uc, uc_mem_type type, uint64_t address, int size, int64_t value, void *user_data) {
-  printf(">>> Unmapped memory access at %p, data size = %p, data value = %p\n", address, size, value);
   auto emu = (UniconEmulator *)user_data;
+  if (emu->trace_)
+    printf(">>> Unmapped memory access at %p, data size = %p, data value = %p\n", address, size, value);
   emu->setUnmappedAddr(address);
   emu->stop();
 }
@@ -61,10 +61,13 @@ public:
   std::string arch_;
   uintptr_t start_, end_;
 
+  // disassemble every executed instruction, turn off for bulk runs
+  bool trace_ = true;
+
 private:
   uc_err err_;
   uc_engine *uc_;
-  uintptr_t unmapped_addr_;
+  uintptr_t unmapped_addr_ = 0;
 };
 
 void set_global_arch(std::string arch);
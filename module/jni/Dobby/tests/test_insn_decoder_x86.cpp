@@ -1,267 +1,238 @@
-#include "InstructionRelocation/InstructionRelocation.h"
-#include "InstructionRelocation/arm64/InstructionRelocationARM64.h"
-
-#include <capstone.h>
-#include <unicorn/unicorn.h>
-
-#include <iostream>
-
-class CapstoneDisassembler {
-public:
-  void disassemble(uintptr_t addr, char *buffer, size_t buffer_szie);
-
-  static CapstoneDisassembler *Get(const std::string &arch);
-
-private:
-  CapstoneDisassembler(const std::string &arch, csh csh_);
-
-  ~CapstoneDisassembler();
-
-private:
-  csh csh_;
+#include "InstructionRelocation/x86/x86_insn_decode/x86_insn_decode.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+  const char *bytes;
+  int mode;
+  uint32_t length;
+  bool branch_relative;
+  bool ip_relative;
+  const char *desc;
+} decoder_case_t;
+
+// clang-format off
+static const decoder_case_t decoder_cases[] = {
+  {"\x55", 64, 1, false, false, "push rbp"},
+  {"\x48\x89\xe5", 64, 3, false, false, "mov rbp, rsp"},
+  {"\x41\x57", 64, 2, false, false, "push r15"},
+  {"\x48\x83\xec\x20", 64, 4, false, false, "sub rsp, 0x20"},
+  {"\x48\x81\xec\x00\x01\x00\x00", 64, 7, false, false, "sub rsp, 0x100"},
+  {"\x48\x8b\x44\x24\x08", 64, 5, false, false, "mov rax, [rsp + 8]"},
+  {"\x48\x8b\x04\x24", 64, 4, false, false, "mov rax, [rsp]"},
+  {"\x48\x8b\x04\x25\x00\x10\x00\x00", 64, 8, false, false, "mov rax, [0x1000]"},
+  {"\x48\x8b\x04\xcd\x00\x10\x00\x00", 64, 8, false, false, "mov rax, [rcx * 8 + 0x1000]"},
+  {"\x48\x8b\x44\x8d\x10", 64, 5, false, false, "mov rax, [rbp + rcx * 4 + 0x10]"},
+  {"\x48\x8b\x07", 64, 3, false, false, "mov rax, [rdi]"},
+  {"\x49\x8b\x06", 64, 3, false, false, "mov rax, [r14]"},
+  {"\x48\x8b\x45\x00", 64, 4, false, false, "mov rax, [rbp + 0]"},
+  {"\x49\x8b\x45\x00", 64, 4, false, false, "mov rax, [r13 + 0]"},
+  {"\x48\x8b\x05\x00\x40\x00\x00", 64, 7, false, true, "mov rax, [rip + 0x4000]"},
+  {"\x48\x8d\x05\x00\x40\x00\x00", 64, 7, false, true, "lea rax, [rip + 0x4000]"},
+  {"\x48\xb8\x88\x77\x66\x55\x44\x33\x22\x11", 64, 10, false, false, "movabs rax, imm64"},
+  {"\xb8\x44\x33\x22\x11", 64, 5, false, false, "mov eax, imm32"},
+  {"\x66\xb8\x22\x11", 64, 4, false, false, "mov ax, imm16"},
+  {"\xc7\x45\xfc\x00\x00\x00\x00", 64, 7, false, false, "mov dword ptr [rbp - 4], 0"},
+  {"\x66\xc7\x45\xfc\x00\x00", 64, 6, false, false, "mov word ptr [rbp - 4], 0"},
+  {"\xf7\xc0\x01\x00\x00\x00", 64, 6, false, false, "test eax, 1"},
+  {"\xf7\xd8", 64, 2, false, false, "neg eax"},
+  {"\xf6\x47\x08\x01", 64, 4, false, false, "test byte ptr [rdi + 8], 1"},
+  {"\xff\x25\x00\x10\x00\x00", 64, 6, false, true, "jmp [rip + 0x1000]"},
+  {"\xff\x15\x00\x10\x00\x00", 64, 6, false, true, "call [rip + 0x1000]"},
+  {"\xff\xe0", 64, 2, false, false, "jmp rax"},
+  {"\x41\xff\xd3", 64, 3, false, false, "call r11"},
+  {"\x74\x10", 64, 2, true, false, "jz rel8"},
+  {"\x0f\x84\x00\x10\x00\x00", 64, 6, true, false, "jz rel32"},
+  {"\xeb\xfe", 64, 2, true, false, "jmp rel8"},
+  {"\xe9\x00\x10\x00\x00", 64, 5, true, false, "jmp rel32"},
+  {"\xe8\x00\x10\x00\x00", 64, 5, true, false, "call rel32"},
+  {"\xe3\x10", 64, 2, true, false, "jrcxz rel8"},
+  {"\x0f\xeb\xc1", 64, 3, false, false, "por mm0, mm1"},
+  {"\x0f\x70\xc1\x1b", 64, 4, false, false, "pshufw mm0, mm1, 0x1b"},
+  {"\x0f\x1f\x44\x00\x00", 64, 5, false, false, "nop dword ptr [rax + rax]"},
+  {"\x66\x0f\x1f\x84\x00\x00\x00\x00\x00", 64, 9, false, false, "nop word ptr [rax + rax]"},
+  {"\xf3\x0f\x1e\xfa", 64, 4, false, false, "endbr64"},
+  {"\x66\x0f\x3a\x0f\xc1\x08", 64, 6, false, false, "palignr xmm0, xmm1, 8"},
+  {"\x66\x0f\x38\x00\xc1", 64, 5, false, false, "pshufb xmm0, xmm1"},
+  {"\xc5\xf8\x77", 64, 3, false, false, "vzeroupper"},
+  {"\xc5\xfd\x6f\x07", 64, 4, false, false, "vmovdqa ymm0, [rdi]"},
+  {"\xc4\xe3\x7d\x18\xc1\x01", 64, 6, false, false, "vinsertf128 ymm0, ymm0, xmm1, 1"},
+  {"\xd9\x45\xf8", 64, 3, false, false, "fld dword ptr [rbp - 8]"},
+  {"\xc8\x10\x00\x00", 64, 4, false, false, "enter 0x10, 0"},
+  {"\x48\xa1\x00\x10\x00\x00\x00\x00\x00\x00", 64, 10, false, false, "movabs rax, [moffs64]"},
+  {"\xf0\x48\x0f\xb1\x0f", 64, 5, false, false, "lock cmpxchg [rdi], rcx"},
+  {"\x64\x48\x8b\x04\x25\x28\x00\x00\x00", 64, 9, false, false, "mov rax, fs:[0x28]"},
+  {"\xc3", 64, 1, false, false, "ret"},
+  {"\xc2\x08\x00", 64, 3, false, false, "ret 8"},
+
+  {"\x8b\x45\x08", 32, 3, false, false, "mov eax, [ebp + 8]"},
+  {"\xa1\x00\x10\x00\x00", 32, 5, false, false, "mov eax, [moffs32]"},
+  {"\x8b\x05\x00\x10\x00\x00", 32, 6, false, false, "mov eax, [0x1000]"},
+  {"\x0f\x85\x00\x10\x00\x00", 32, 6, true, false, "jnz rel32"},
+  {"\x66\xe9\x00\x10", 32, 4, true, false, "jmp rel16"},
+  {"\xc4\x00", 32, 2, false, false, "les eax, [eax]"},
+  {"\x68\x00\x10\x00\x00", 32, 5, false, false, "push imm32"},
+  {"\x67\x8b\x46\x08", 32, 4, false, false, "mov eax, [bp + 8]"},
+};
 
-  static CapstoneDisassembler *instance_;
+typedef struct {
+  const char *bytes;
+  int mode;
+  uint32_t length;
+  int64_t immediate;
+  const char *desc;
+} branch_case_t;
+
+// the displacements of relative branches are sign extended
+static const branch_case_t branch_cases[] = {
+  {"\xeb\xfe", 64, 2, -2, "jmp rel8"},
+  {"\xe8\xfb\xff\xff\xff", 64, 5, -5, "call rel32"},
+  {"\x0f\x8c\x00\xf0\xff\xff", 64, 6, -0x1000, "jl rel32"},
+  {"\x66\xe9\xf0\xff", 32, 4, -16, "jmp rel16"},
+  {"\x66\xe8\x00\x80", 32, 4, -0x8000, "call rel16"},
+  {"\x66\xe9\xff\x7f", 32, 4, 0x7fff, "jmp rel16 forward"},
 };
 
-CapstoneDisassembler *CapstoneDisassembler::instance_ = nullptr;
+// prologue instructions whose operands are fully described by the reference decoder's specs
+static const decoder_case_t decoder_corpus[] = {
+  {"\x55", 64, 1},
+  {"\x48\x89\xe5", 64, 3},
+  {"\x41\x57", 64, 2},
+  {"\x41\x56", 64, 2},
+  {"\x53", 64, 1},
+  {"\x48\x83\xec\x28", 64, 4},
+  {"\x48\x81\xec\x00\x01\x00\x00", 64, 7},
+  {"\x48\x8b\x44\x24\x08", 64, 5},
+  {"\x48\x89\x5c\x24\x10", 64, 5},
+  {"\x48\x8b\x05\x00\x40\x00\x00", 64, 7},
+  {"\x48\x8d\x05\x00\x40\x00\x00", 64, 7},
+  {"\x48\x8d\x3d\x00\x40\x00\x00", 64, 7},
+  {"\x31\xc0", 64, 2},
+  {"\x89\xf8", 64, 2},
+  {"\xb8\x44\x33\x22\x11", 64, 5},
+  {"\x48\x85\xff", 64, 3},
+  {"\x39\xc0", 64, 2},
+  {"\x74\x10", 64, 2},
+  {"\x75\xf0", 64, 2},
+  {"\xeb\xfe", 64, 2},
+  {"\xe9\x00\x10\x00\x00", 64, 5},
+  {"\xe8\x00\x10\x00\x00", 64, 5},
+  {"\xc3", 64, 1},
+  {"\x90", 64, 1},
+};
+// clang-format on
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+static void decode(bool reference, const decoder_case_t *c, x86_insn_decode_t *insn) {
+  // decoders may read past the instruction, keep the tail zeroed
+  uint8_t buffer[32] = {0};
+  memcpy(buffer, c->bytes, c->length);
+
+  x86_options_t conf = {0};
+  conf.mode = c->mode;
+  memset(insn, 0, sizeof(x86_insn_decode_t));
+  if (reference)
+    x86_insn_decode_spec(insn, buffer, &conf);
+  else
+    x86_insn_decode(insn, buffer, &conf);
+}
 
-CapstoneDisassembler *CapstoneDisassembler::Get(const std::string &arch) {
-  if (instance_ == nullptr) {
-    cs_err err = CS_ERR_OK;
-    csh csh_;
-    if (arch == "arm") {
-      err = cs_open(CS_ARCH_ARM, CS_MODE_ARM, &csh_);
-    } else if (arch == "arm64") {
-      err = cs_open(CS_ARCH_ARM64, CS_MODE_ARM, &csh_);
-    } else if (arch == "x86_64") {
-      err = cs_open(CS_ARCH_X86, CS_MODE_64, &csh_);
-    } else if (arch == "x86") {
-      err = cs_open(CS_ARCH_X86, CS_MODE_32, &csh_);
+static int check_decoder_cases() {
+  int failed = 0;
+  for (size_t i = 0; i < ARRAY_SIZE(decoder_cases); i++) {
+    const decoder_case_t *c = &decoder_cases[i];
+    x86_insn_decode_t insn;
+    decode(false, c, &insn);
+
+    bool branch_relative = insn.flags & X86_INSN_DECODE_FLAG_BRANCH_RELATIVE;
+    bool ip_relative = insn.flags & X86_INSN_DECODE_FLAG_IP_RELATIVE;
+    if (insn.length != c->length || branch_relative != c->branch_relative || ip_relative != c->ip_relative) {
+      printf("[-] %s: length %d (expect %d), branch relative %d (expect %d), ip relative %d (expect %d)\n", c->desc,
+             insn.length, c->length, branch_relative, c->branch_relative, ip_relative, c->ip_relative);
+      failed++;
     }
-    instance_ = new CapstoneDisassembler(arch, csh_);
   }
-  return instance_;
-}
-
-CapstoneDisassembler::CapstoneDisassembler(const std::string &arch, csh csh_) : csh_(csh_) {
-}
-
-CapstoneDisassembler::~CapstoneDisassembler() {
-  cs_close((csh *)&csh_);
+  return failed;
 }
 
-void CapstoneDisassembler::disassemble(uintptr_t addr, char *buffer, size_t buffer_size) {
-  cs_insn *insns;
-
-  size_t count = cs_disasm(csh_, (uint8_t *)buffer, buffer_size, addr, 0, &insns);
-  for (size_t i = 0; i < count; ++i) {
-    auto &insn = insns[i];
-    printf("%s %p: %s %s\n", "-", insn.address, insn.mnemonic, insn.op_str);
+static int check_branch_cases() {
+  int failed = 0;
+  for (size_t i = 0; i < ARRAY_SIZE(branch_cases); i++) {
+    const branch_case_t *c = &branch_cases[i];
+    decoder_case_t insn_case = {c->bytes, c->mode, c->length};
+    x86_insn_decode_t insn;
+    decode(false, &insn_case, &insn);
+
+    if (insn.length != c->length || insn.immediate != c->immediate) {
+      printf("[-] %s: length %d (expect %d), immediate %lld (expect %lld)\n", c->desc, insn.length, c->length,
+             (long long)insn.immediate, (long long)c->immediate);
+      failed++;
+    }
   }
-  cs_free(insns, count);
+  return failed;
 }
 
-class UniconEmulator {
-public:
-  UniconEmulator(const std::string &arch);
-
-  void mapMemory(uintptr_t addr, char *buffer, size_t buffer_size);
-
-  void *readRegister(int regId);
-
-  void writeRegister(int regId, void *value);
-
-  void start(uintptr_t addr, uintptr_t end);
-
-  void stop() {
-    uc_emu_stop(uc_);
-  }
-
-  void emulate(uintptr_t addr, char *buffer, size_t buffer_size);
-
-  void setUnmappedAddr(uintptr_t addr) {
-    unmapped_addr_ = addr;
-  }
-
-  intptr_t getFaultAddr() {
-    return unmapped_addr_;
+static int check_decoder_corpus() {
+  int failed = 0;
+  for (size_t i = 0; i < ARRAY_SIZE(decoder_corpus); i++) {
+    const decoder_case_t *c = &decoder_corpus[i];
+    x86_insn_decode_t fast, reference;
+    decode(false, c, &fast);
+    decode(true, c, &reference);
+
+    if (fast.length != reference.length || fast.length != c->length ||
+        fast.immediate_offset != reference.immediate_offset ||
+        fast.displacement_offset != reference.displacement_offset || fast.primary_opcode != reference.primary_opcode ||
+        fast.flags != reference.flags) {
+      printf("[-] corpus %zu: length %d / %d, imm offset %d / %d, disp offset %d / %d, flags 0x%x / 0x%x\n", i,
+             fast.length, reference.length, fast.immediate_offset, reference.immediate_offset,
+             fast.displacement_offset, reference.displacement_offset, fast.flags, reference.flags);
+      failed++;
+    }
   }
-
-  void reset();
-
-private:
-private:
-  uc_err err_;
-  uc_engine *uc_;
-  uintptr_t unmapped_addr_;
-};
-
-static void hook_trace_insn(uc_engine *uc, uint64_t address, uint32_t size, void *user_data) {
-  auto emu = (UniconEmulator *)user_data;
-  uc_err err;
-  char insn_bytes[16];
-  err = uc_mem_read(uc, address, insn_bytes, size);
-  assert(err == UC_ERR_OK);
-  CapstoneDisassembler::Get("arm64")->disassemble(address, (char *)insn_bytes, size);
+  return failed;
 }
 
-static void hook_unmapped(uc_engine *uc, uc_mem_type type, uint64_t address, int size, int64_t value, void *user_data) {
-  printf(">>> Unmapped memory access at %p, data size = %p, data value = %p\n", address, size, value);
-  auto emu = (UniconEmulator *)user_data;
-  emu->setUnmappedAddr(address);
-  emu->stop();
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
 }
 
-void dump_regions(uc_engine *uc) {
-  uc_mem_region *regions;
-  uint32_t region_count;
-  uc_mem_regions(uc, &regions, &region_count);
-  for (int i = 0; i < region_count; ++i) {
-    auto &region = regions[i];
-    printf("region: %p - %p\n", region.begin, region.end);
-  }
-}
+static double benchmark_decoder(bool reference, int rounds) {
+  x86_insn_decode_t insn;
+  volatile uint32_t sink = 0;
 
-UniconEmulator::UniconEmulator(const std::string &arch) {
-  uc_err err = UC_ERR_OK;
-  if (arch == "arm") {
-    err = uc_open(UC_ARCH_ARM, UC_MODE_ARM, &uc_);
-  } else if (arch == "arm64") {
-    err = uc_open(UC_ARCH_ARM64, UC_MODE_ARM, &uc_);
-  } else if (arch == "x86_64") {
-    err = uc_open(UC_ARCH_X86, UC_MODE_64, &uc_);
-  } else if (arch == "x86") {
-    err = uc_open(UC_ARCH_X86, UC_MODE_32, &uc_);
+  double start = now();
+  for (int r = 0; r < rounds; r++) {
+    for (size_t i = 0; i < ARRAY_SIZE(decoder_corpus); i++) {
+      decode(reference, &decoder_corpus[i], &insn);
+      sink = sink + insn.length;
+    }
   }
-  assert(err == UC_ERR_OK);
-
-  uc_hook hook_trace_insn_handle;
-  uc_hook_add(uc_, &hook_trace_insn_handle, UC_HOOK_CODE, (void *)hook_trace_insn, this, 1, 0);
-
-  uc_hook hook_unmapped_handle;
-  uc_hook_add(uc_, &hook_unmapped_handle, UC_HOOK_MEM_UNMAPPED, (void *)hook_unmapped, this, 1, 0);
-}
-
-void UniconEmulator::mapMemory(uintptr_t addr, char *buffer, size_t buffer_size) {
-  uc_err err = UC_ERR_OK;
-  uintptr_t map_addr = ALIGN_FLOOR(addr, 0x1000);
-  size_t map_size = ALIGN_CEIL(buffer_size, 0x1000);
-  err = uc_mem_map(uc_, map_addr, map_size, UC_PROT_ALL);
-  assert(err == UC_ERR_OK);
-  err = uc_mem_write(uc_, addr, buffer, buffer_size);
-  assert(err == UC_ERR_OK);
-}
-
-void *UniconEmulator::readRegister(int regId) {
-  void *value = nullptr;
-  uc_reg_read(uc_, regId, &value);
-  return value;
-}
-
-void UniconEmulator::writeRegister(int regNdx, void *value) {
-  uc_reg_write(uc_, regNdx, (void *)&value);
-}
-
-void UniconEmulator::start(uintptr_t addr, uintptr_t end) {
-  uc_err err;
-  err = uc_emu_start(uc_, addr, end, 0, 0);
-  if (err == UC_ERR_FETCH_UNMAPPED || err ==  UC_ERR_READ_UNMAPPED || err == UC_ERR_WRITE_UNMAPPED)
-    err = UC_ERR_OK;
-  assert(err == UC_ERR_OK);
-}
-
-void UniconEmulator::emulate(uintptr_t addr, char *buffer, size_t buffer_size) {
-  uc_err err;
-  mapMemory(addr, buffer, buffer_size);
-  writeRegister(UC_ARM_REG_PC, (void *)addr);
-  start(addr, addr + buffer_size);
+  double elapsed = now() - start;
+  return rounds * ARRAY_SIZE(decoder_corpus) / elapsed;
 }
 
-void check_insn_relo(char *buffer, size_t buffer_size, bool check_fault_addr, int check_reg_id,
-                     void (^callback)(UniconEmulator *orig, UniconEmulator *relo)) {
-  auto *orig_ue = new UniconEmulator("arm64");
-  auto *relo_ue = new UniconEmulator("arm64");
-
-  addr_t orig_addr = 0x100004000;
-  addr_t relocate_addr = 0x200004000;
-
-  //  auto dism = CapstoneDisassembler::Get("arm64");
-  //  dism->disassemble((uintptr_t)orig_addr, buffer, buffer_size);
-  //  printf("\n");
-
-  auto origin = new CodeMemBlock(orig_addr, buffer_size);
-  auto relocated = new CodeMemBlock();
-
-  GenRelocateCode(buffer, origin, relocated, false);
-
-  orig_ue->emulate(orig_addr, buffer, buffer_size);
-  relo_ue->emulate(relocate_addr, (char *)relocated->addr, relocated->size);
-
-  //  dism->disassemble((uintptr_t)relocate_addr, (char *)relocated->addr, relocated->size);
-  //  printf("\n");
-
-  if (check_fault_addr) {
-    assert(orig_ue->getFaultAddr() == relo_ue->getFaultAddr());
-  } else if (check_reg_id != -1) {
-    assert(orig_ue->readRegister(check_reg_id) == relo_ue->readRegister(check_reg_id));
-  } else if (callback) {
-    callback(orig_ue, relo_ue);
+int main(int argc, char *argv[]) {
+  int failed = check_decoder_cases();
+  failed += check_branch_cases();
+  failed += check_decoder_corpus();
+  if (failed) {
+    printf("[-] %d decoder mismatches\n", failed);
+    return 1;
   }
-
-  delete orig_ue;
-  delete relo_ue;
-}
-
-int main() {
-  // b #-0x4000
-  check_insn_relo("\x00\xf0\xff\x17", 4, true, -1, nullptr);
-  // b #0x4000
-  check_insn_relo("\x00\x10\x00\x14", 4, true, -1, nullptr);
-
-  // bl #-0x4000
-  check_insn_relo("\x00\xf0\xff\x97", 4, true, -1, nullptr);
-  // bl #0x4000
-  check_insn_relo("\x00\x10\x00\x94", 4, true, -1, nullptr);
-
-  // mov x0, #0
-  // cbz x0, #-0x4000
-  check_insn_relo("\x00\x00\x80\xd2\x00\x00\xfe\xb4", 8, true, -1, nullptr);
-  // mov x0, #0
-  // cbz x0, #0x4000
-  check_insn_relo("\x00\x00\x80\xd2\x00\x00\x02\xb4", 8, true, -1, nullptr);
-
-  // ldr x0, #-0x4000
-  check_insn_relo("\x00\x00\xfe\x58", 4, true, -1, nullptr);
-  // ldr x0, #0x4000
-  check_insn_relo("\x00\x00\x02\x58", 4, true, -1, nullptr);
-
-  // adr x0, #-0x4000
-  check_insn_relo("\x00\x00\xfe\x10", 4, false, UC_ARM64_REG_X0, nullptr);
-  // adr x0, #0x4000
-  check_insn_relo("\x00\x00\x02\x10", 4, false, UC_ARM64_REG_X0, nullptr);
-
-  // adrp x0, #-0x4000
-  check_insn_relo("\xe0\xff\xff\x90", 4, false, UC_ARM64_REG_X0, nullptr);
-  // adrp x0, #0x4000
-  check_insn_relo("\x20\x00\x00\x90", 4, false, UC_ARM64_REG_X0, nullptr);
-
-  // mov x0, #0
-  // cmp x0, #0
-  // b.eq #-0x4000
-  check_insn_relo("\x00\x00\x80\xd2\x1f\x00\x00\xf1\x00\x00\xfe\x54", 12, true, -1, nullptr);
-  // mov x0, #0
-  // cmp x0, #0
-  // b.eq #0x4000
-  check_insn_relo("\x00\x00\x80\xd2\x1f\x00\x00\xf1\x00\x00\x02\x54", 12, true, -1, nullptr);
-
-  // mov x0, #0xb
-  // tbz w0, 2, #-0x4000
-  check_insn_relo("\x60\x01\x80\xd2\x00\x00\x16\x36", 8, true, -1, nullptr);
-  // mov x0, #0xb
-
-  // mov x0, #0xb
-  // tbz w0, 2, #0x4000
-  check_insn_relo("\x60\x01\x80\xd2\x00\x00\x12\x36", 8, true, -1, nullptr);
-
+  printf("[+] %zu cases, %zu branches, %zu corpus insns ok\n", ARRAY_SIZE(decoder_cases), ARRAY_SIZE(branch_cases),
+         ARRAY_SIZE(decoder_corpus));
+
+  int rounds = argc > 1 ? atoi(argv[1]) : 100000;
+  double fast = benchmark_decoder(false, rounds);
+  double reference = benchmark_decoder(true, rounds);
+  printf("[+] table decoder %.0f insns/s, spec decoder %.0f insns/s, speedup %.2fx\n", fast, reference,
+         fast / reference);
   return 0;
 }
@@ -1,7 +1,11 @@
 #include "InstructionRelocation/InstructionRelocation.h"
 
+#include "InstructionRelocation/arm/InstructionRelocationARM.h"
+
 #include "UniconEmulator.h"
 
+#include <time.h>
+
 void check_insn_relo_arm(char *buffer, size_t buffer_size, bool check_fault_addr, int check_reg_id,
                          void (^callback)(UniconEmulator *orig, UniconEmulator *relo)) {
   __attribute__((aligned(4))) char code[64] = {0};
@@ -16,6 +20,38 @@ void check_insn_relo_thumb(char *buffer, size_t buffer_size, bool check_fault_ad
   check_insn_relo(code, buffer_size, check_fault_addr, check_reg_id, callback, relo_stop_size);
 }
 
+// common bionic prologues, relocated by the thumb fast path and by the generic path
+static void bench_thumb_relocation() {
+  const struct {
+    const char *code;
+    size_t size;
+  } prologues[] = {
+      {"\xf0\xb5\x03\xaf\x82\xb0", 6},                 // push {r4-r7, lr}; add r7, sp, #12; sub sp, #8
+      {"\x2d\xe9\xf0\x4f\xad\xf5\x80\x7d", 8},         // push.w {r4-r11, lr}; sub.w sp, sp, #0x100
+      {"\x10\xb5\x02\x4c\xdf\xf8\x40\x00", 8},         // push {r4, lr}; ldr r4, [pc, #8]; ldr.w r0, [pc, #0x40]
+      {"\x80\xb5\x6f\x46\x04\x46\x0d\x46", 8},         // push {r7, lr}; mov r7, sp; mov r4, r0; mov r5, r1
+  };
+
+  for (int fast = 1; fast >= 0; fast--) {
+    set_thumb_fast_relocation_enabled(fast);
+
+    const int rounds = 10000;
+    clock_t start = clock();
+    for (int i = 0; i < rounds; i++) {
+      for (auto &prologue : prologues) {
+        __attribute__((aligned(4))) char code[64] = {0};
+        memcpy(code, prologue.code, prologue.size);
+        CodeMemBlock origin(0x10014000 + 1, prologue.size), relocated;
+        GenRelocateCodeAndBranch(code + 1, &origin, &relocated);
+      }
+    }
+    double elapsed = (double)(clock() - start) / CLOCKS_PER_SEC;
+    printf("[bench] thumb %s path: %.0f relocations/s\n", fast ? "fast" : "generic",
+           rounds * (sizeof(prologues) / sizeof(prologues[0])) / elapsed);
+  }
+  set_thumb_fast_relocation_enabled(true);
+}
+
 int main() {
   log_set_level(0);
   set_global_arch("arm");
@@ -112,5 +148,44 @@ int main() {
         assert(relo->getFaultAddr() == 0x10014000 + 0x512 + 4);
       },
       0xc);
+
+  // thumb fast path, position independent prologue copied as is
+  // push {r4, r5, r6, r7, lr}
+  // add r7, sp, #12
+  // sub sp, #8
+  check_insn_relo_thumb("\xf0\xb5"
+                        "\x03\xaf"
+                        "\x82\xb0",
+                        6, false, UC_ARM_REG_R7, nullptr);
+  // push.w {r4-r11, lr}
+  // sub.w sp, sp, #0x100
+  check_insn_relo_thumb("\x2d\xe9\xf0\x4f"
+                        "\xad\xf5\x80\x7d",
+                        8, false, UC_ARM_REG_SP, nullptr);
+  // push {r4, lr}
+  // sub sp, #8
+  // str r0, [sp, #4]
+  // strh r1, [r0, #2]
+  check_insn_relo_thumb("\x10\xb5"
+                        "\x82\xb0"
+                        "\x01\x90"
+                        "\x41\x80",
+                        8, false, UC_ARM_REG_SP, nullptr);
+  // push {r4, lr}
+  // ldr r4, [pc, #8]
+  check_insn_relo_thumb("\x10\xb5"
+                        "\x02\x4c",
+                        4, false, -1, ^(UniconEmulator *orig, UniconEmulator *relo) {
+                          assert(relo->getFaultAddr() == 0x1001400c);
+                        });
+  // push {r4, lr}
+  // ldr.w r0, [pc, #0x40]
+  check_insn_relo_thumb("\x10\xb5"
+                        "\xdf\xf8\x40\x00",
+                        6, false, -1, ^(UniconEmulator *orig, UniconEmulator *relo) {
+                          assert(relo->getFaultAddr() == 0x10014044);
+                        });
+
+  bench_thumb_relocation();
   return 0;
 }
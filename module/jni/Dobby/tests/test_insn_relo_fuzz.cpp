@@ -0,0 +1,538 @@
+// differential fuzzing of the instruction relocator
+//
+// each case is a random prologue built from valid instruction templates, relocated with GenRelocateCodeAndBranch.
+// the original and the relocated copy are emulated from the same register state, both must leave the same
+// registers, or fault at the same address.
+//
+// usage: test_insn_relo_fuzz_<arch> [iterations] [seed]
+// libFuzzer: build with -fsanitize=fuzzer -DDOBBY_LIBFUZZER, the input only seeds the generator
+
+#include "InstructionRelocation/InstructionRelocation.h"
+
+#include "UniconEmulator.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FUZZ_MAX_PROLOGUE_SIZE 64
+#define FUZZ_MAX_INSN_COUNT 8
+
+// the relocated page sits at +0x10000 and the second source address at +0x1000000,
+// far pc-relative targets stay out of the relocated page
+#define FUZZ_FAR_OFFSET_MIN 0x20000
+#define FUZZ_FAR_OFFSET_MAX 0x800000
+
+typedef struct {
+  int reg_id;
+  uint64_t mask;
+} fuzz_reg_t;
+
+typedef struct {
+  __attribute__((aligned(4))) uint8_t code[FUZZ_MAX_PROLOGUE_SIZE];
+  uint32_t size;
+} fuzz_prologue_t;
+
+static uint64_t fuzz_rng_state = 0x2545f4914f6cdd1d;
+
+static void fuzz_seed(uint64_t seed) {
+  fuzz_rng_state = seed ? seed : 0x2545f4914f6cdd1d;
+}
+
+// xorshift64*
+static uint64_t fuzz_rand() {
+  fuzz_rng_state ^= fuzz_rng_state >> 12;
+  fuzz_rng_state ^= fuzz_rng_state << 25;
+  fuzz_rng_state ^= fuzz_rng_state >> 27;
+  return fuzz_rng_state * 0x2545f4914f6cdd1dULL;
+}
+
+static uint32_t fuzz_rand_below(uint32_t n) {
+  return (uint32_t)(fuzz_rand() % n);
+}
+
+// random signed offset with magnitude in [min, max], aligned to align
+static int64_t fuzz_rand_offset(int64_t min, int64_t max, int64_t align) {
+  int64_t offset = min + (int64_t)(fuzz_rand() % (uint64_t)(max - min + 1));
+  offset &= ~(align - 1);
+  if (offset < min)
+    offset += align;
+  return (fuzz_rand() & 1) ? offset : -offset;
+}
+
+static void fuzz_emit32(fuzz_prologue_t *prologue, uint32_t inst) {
+  memcpy(prologue->code + prologue->size, &inst, sizeof(uint32_t));
+  prologue->size += sizeof(uint32_t);
+}
+
+static void fuzz_emit8(fuzz_prologue_t *prologue, uint8_t byte) {
+  prologue->code[prologue->size++] = byte;
+}
+
+#if defined(TARGET_ARCH_ARM64)
+
+static const char *fuzz_arch = "arm64";
+static addr_t fuzz_orig_addr = 0x100014000;
+static addr_t fuzz_relocate_addr = 0x100024000;
+static const int fuzz_pc_reg = UC_ARM64_REG_PC;
+
+// x16, x17 are relocator scratch, x30 differs by design after a relocated bl
+static fuzz_reg_t fuzz_regs[] = {
+    {UC_ARM64_REG_X0, ~0ULL},  {UC_ARM64_REG_X1, ~0ULL},  {UC_ARM64_REG_X2, ~0ULL},  {UC_ARM64_REG_X3, ~0ULL},
+    {UC_ARM64_REG_X4, ~0ULL},  {UC_ARM64_REG_X5, ~0ULL},  {UC_ARM64_REG_X6, ~0ULL},  {UC_ARM64_REG_X7, ~0ULL},
+    {UC_ARM64_REG_X8, ~0ULL},  {UC_ARM64_REG_X9, ~0ULL},  {UC_ARM64_REG_X10, ~0ULL}, {UC_ARM64_REG_X11, ~0ULL},
+    {UC_ARM64_REG_X12, ~0ULL}, {UC_ARM64_REG_X13, ~0ULL}, {UC_ARM64_REG_X14, ~0ULL}, {UC_ARM64_REG_X15, ~0ULL},
+    {UC_ARM64_REG_NZCV, 0xf0000000},
+};
+
+static uint32_t fuzz_reg() {
+  return fuzz_rand_below(16);
+}
+
+static uint32_t fuzz_imm19(int64_t offset) {
+  return ((uint32_t)(offset >> 2) & 0x7ffff) << 5;
+}
+
+static void fuzz_gen_data_insn(fuzz_prologue_t *prologue) {
+  uint32_t rd = fuzz_reg(), rn = fuzz_reg(), rm = fuzz_reg();
+  uint32_t imm12 = fuzz_rand_below(0x1000);
+  switch (fuzz_rand_below(9)) {
+  case 0: // add xd, xn, #imm12
+    fuzz_emit32(prologue, 0x91000000 | (imm12 << 10) | (rn << 5) | rd);
+    break;
+  case 1: // sub xd, xn, #imm12
+    fuzz_emit32(prologue, 0xd1000000 | (imm12 << 10) | (rn << 5) | rd);
+    break;
+  case 2: // subs xd, xn, #imm12
+    fuzz_emit32(prologue, 0xf1000000 | (imm12 << 10) | (rn << 5) | rd);
+    break;
+  case 3: // movz xd, #imm16, lsl #hw
+    fuzz_emit32(prologue, 0xd2800000 | (fuzz_rand_below(4) << 21) | (fuzz_rand_below(0x10000) << 5) | rd);
+    break;
+  case 4: // movk xd, #imm16, lsl #hw
+    fuzz_emit32(prologue, 0xf2800000 | (fuzz_rand_below(4) << 21) | (fuzz_rand_below(0x10000) << 5) | rd);
+    break;
+  case 5: // eor xd, xn, xm
+    fuzz_emit32(prologue, 0xca000000 | (rm << 16) | (rn << 5) | rd);
+    break;
+  case 6: // adds xd, xn, xm
+    fuzz_emit32(prologue, 0xab000000 | (rm << 16) | (rn << 5) | rd);
+    break;
+  case 7: { // adr xd, #imm21
+    uint32_t imm21 = fuzz_rand_below(1 << 21);
+    fuzz_emit32(prologue, 0x10000000 | ((imm21 & 3) << 29) | ((imm21 >> 2) << 5) | rd);
+  } break;
+  case 8: { // adrp xd, #imm21 << 12
+    uint32_t imm21 = fuzz_rand_below(1 << 21);
+    fuzz_emit32(prologue, 0x90000000 | ((imm21 & 3) << 29) | ((imm21 >> 2) << 5) | rd);
+  } break;
+  }
+}
+
+// conditional branches may fall through, keep generating after them
+static void fuzz_gen_cond_branch(fuzz_prologue_t *prologue) {
+  uint32_t rt = fuzz_reg();
+  switch (fuzz_rand_below(3)) {
+  case 0: // b.cond, skip al and nv, the inverted condition of al is not a branch-never
+    fuzz_emit32(prologue, 0x54000000 | fuzz_imm19(fuzz_rand_offset(FUZZ_FAR_OFFSET_MIN, 0xffffc, 4)) |
+                              fuzz_rand_below(14));
+    break;
+  case 1: // cbz/cbnz xt / wt
+    fuzz_emit32(prologue, 0x34000000 | (fuzz_rand_below(2) << 31) | (fuzz_rand_below(2) << 24) |
+                              fuzz_imm19(fuzz_rand_offset(FUZZ_FAR_OFFSET_MIN, 0xffffc, 4)) | rt);
+    break;
+  case 2: { // tbz/tbnz xt, #bit
+    uint32_t bit_pos = fuzz_rand_below(64);
+    int64_t offset = fuzz_rand_offset(0x2000, 0x7ffc, 4);
+    fuzz_emit32(prologue, 0x36000000 | ((bit_pos >> 5) << 31) | (fuzz_rand_below(2) << 24) | ((bit_pos & 0x1f) << 19) |
+                              (((uint32_t)(offset >> 2) & 0x3fff) << 5) | rt);
+  } break;
+  }
+}
+
+// always leaves the prologue, must be the last instruction
+static void fuzz_gen_exit_insn(fuzz_prologue_t *prologue) {
+  // imm19 range, shared by b / bl
+  int64_t offset = fuzz_rand_offset(FUZZ_FAR_OFFSET_MIN, 0xffffc, 4);
+  switch (fuzz_rand_below(3)) {
+  case 0: // b / bl
+    fuzz_emit32(prologue, 0x14000000 | (fuzz_rand_below(2) << 31) | ((uint32_t)(offset >> 2) & 0x3ffffff));
+    break;
+  case 1: // ldr wt, #imm19
+    fuzz_emit32(prologue, 0x18000000 | fuzz_imm19(offset) | fuzz_reg());
+    break;
+  case 2: // ldr xt, #imm19
+    fuzz_emit32(prologue, 0x58000000 | fuzz_imm19(offset) | fuzz_reg());
+    break;
+  }
+}
+
+static void fuzz_gen_prologue(fuzz_prologue_t *prologue) {
+  prologue->size = 0;
+  int insn_count = 1 + fuzz_rand_below(FUZZ_MAX_INSN_COUNT - 1);
+  for (int i = 0; i < insn_count; i++) {
+    if (fuzz_rand_below(4) == 0)
+      fuzz_gen_cond_branch(prologue);
+    else
+      fuzz_gen_data_insn(prologue);
+  }
+  if (fuzz_rand_below(2))
+    fuzz_gen_exit_insn(prologue);
+}
+
+#elif defined(TARGET_ARCH_ARM)
+
+static const char *fuzz_arch = "arm";
+static addr_t fuzz_orig_addr = 0x10014000;
+static addr_t fuzz_relocate_addr = 0x10024000;
+static const int fuzz_pc_reg = UC_ARM_REG_PC;
+
+// r12 is relocator scratch, lr differs by design after a relocated bl
+static fuzz_reg_t fuzz_regs[] = {
+    {UC_ARM_REG_R0, ~0ULL}, {UC_ARM_REG_R1, ~0ULL}, {UC_ARM_REG_R2, ~0ULL},  {UC_ARM_REG_R3, ~0ULL},
+    {UC_ARM_REG_R4, ~0ULL}, {UC_ARM_REG_R5, ~0ULL}, {UC_ARM_REG_R6, ~0ULL},  {UC_ARM_REG_R7, ~0ULL},
+    {UC_ARM_REG_R8, ~0ULL}, {UC_ARM_REG_R9, ~0ULL}, {UC_ARM_REG_R10, ~0ULL}, {UC_ARM_REG_R11, ~0ULL},
+    {UC_ARM_REG_CPSR, 0xf0000000},
+};
+
+static uint32_t fuzz_reg() {
+  return fuzz_rand_below(12);
+}
+
+static void fuzz_gen_data_insn(fuzz_prologue_t *prologue) {
+  uint32_t rd = fuzz_reg(), rn = fuzz_reg(), rm = fuzz_reg();
+  uint32_t imm12 = fuzz_rand_below(0x1000);
+  switch (fuzz_rand_below(7)) {
+  case 0: // mov rd, #imm
+    fuzz_emit32(prologue, 0xe3a00000 | (rd << 12) | imm12);
+    break;
+  case 1: // add rd, rn, #imm
+    fuzz_emit32(prologue, 0xe2800000 | (rn << 16) | (rd << 12) | imm12);
+    break;
+  case 2: // cmp rn, #imm
+    fuzz_emit32(prologue, 0xe3500000 | (rn << 16) | imm12);
+    break;
+  case 3: // eor rd, rn, rm
+    fuzz_emit32(prologue, 0xe0200000 | (rn << 16) | (rd << 12) | rm);
+    break;
+  case 4: // add rd, pc, #imm (adr)
+    fuzz_emit32(prologue, 0xe28f0000 | (rd << 12) | imm12);
+    break;
+  case 5: // sub rd, pc, #imm (adr)
+    fuzz_emit32(prologue, 0xe24f0000 | (rd << 12) | imm12);
+    break;
+  case 6: // ldr rd, [pc, #+/-imm12], inside the mapped page or the unmapped neighbour
+    fuzz_emit32(prologue, 0xe51f0000 | (fuzz_rand_below(2) << 23) | (rd << 12) | (imm12 & ~3));
+    break;
+  }
+}
+
+static void fuzz_gen_cond_branch(fuzz_prologue_t *prologue) {
+  // b<cond>, not al
+  int64_t offset = fuzz_rand_offset(FUZZ_FAR_OFFSET_MIN, FUZZ_FAR_OFFSET_MAX, 4);
+  fuzz_emit32(prologue, (fuzz_rand_below(14) << 28) | 0x0a000000 | ((uint32_t)(offset >> 2) & 0xffffff));
+}
+
+static void fuzz_gen_exit_insn(fuzz_prologue_t *prologue) {
+  // b / bl
+  int64_t offset = fuzz_rand_offset(FUZZ_FAR_OFFSET_MIN, FUZZ_FAR_OFFSET_MAX, 4);
+  fuzz_emit32(prologue, 0xea000000 | (fuzz_rand_below(2) << 24) | ((uint32_t)(offset >> 2) & 0xffffff));
+}
+
+static void fuzz_gen_prologue(fuzz_prologue_t *prologue) {
+  prologue->size = 0;
+  int insn_count = 1 + fuzz_rand_below(FUZZ_MAX_INSN_COUNT - 1);
+  for (int i = 0; i < insn_count; i++) {
+    if (fuzz_rand_below(4) == 0)
+      fuzz_gen_cond_branch(prologue);
+    else
+      fuzz_gen_data_insn(prologue);
+  }
+  if (fuzz_rand_below(2))
+    fuzz_gen_exit_insn(prologue);
+}
+
+#elif defined(TARGET_ARCH_X64)
+
+static const char *fuzz_arch = "x86_64";
+static addr_t fuzz_orig_addr = 0x100014000;
+static addr_t fuzz_relocate_addr = 0x100024000;
+static const int fuzz_pc_reg = UC_X86_REG_RIP;
+
+// rel8 branches land on a pad right behind the prologue, the pad jumps to an unmapped address
+#define FUZZ_X64_LANDING_PAD_OFFSET 8
+#define FUZZ_X64_LANDING_ADDR 0xdead0000
+
+// rip-relative memory operands are not generated, their relocation runs through a near stub
+// outside the relocated block that the emulator does not map
+
+// in encoding order, rsp is never generated
+static fuzz_reg_t fuzz_regs[] = {
+    {UC_X86_REG_RAX, ~0ULL}, {UC_X86_REG_RCX, ~0ULL}, {UC_X86_REG_RDX, ~0ULL}, {UC_X86_REG_RBX, ~0ULL},
+    {UC_X86_REG_RSP, ~0ULL}, {UC_X86_REG_RBP, ~0ULL}, {UC_X86_REG_RSI, ~0ULL}, {UC_X86_REG_RDI, ~0ULL},
+    {UC_X86_REG_R8, ~0ULL},  {UC_X86_REG_R9, ~0ULL},  {UC_X86_REG_R10, ~0ULL}, {UC_X86_REG_R11, ~0ULL},
+    {UC_X86_REG_R12, ~0ULL}, {UC_X86_REG_R13, ~0ULL}, {UC_X86_REG_R14, ~0ULL}, {UC_X86_REG_R15, ~0ULL},
+    {UC_X86_REG_EFLAGS, 0x8d5}, // cf, pf, af, zf, sf, of
+};
+
+static uint32_t fuzz_reg() {
+  uint32_t reg = fuzz_rand_below(15);
+  return reg >= 4 ? reg + 1 : reg;
+}
+
+static void fuzz_emit_disp32(fuzz_prologue_t *prologue, int32_t disp) {
+  for (int i = 0; i < 4; i++)
+    fuzz_emit8(prologue, (uint8_t)(disp >> (i * 8)));
+}
+
+static void fuzz_gen_data_insn(fuzz_prologue_t *prologue) {
+  static const uint8_t alu_opcodes[] = {0x01 /* add */, 0x29 /* sub */, 0x31 /* xor */, 0x39 /* cmp */};
+  uint32_t rd = fuzz_reg(), rs = fuzz_reg();
+  switch (fuzz_rand_below(2)) {
+  case 0: // mov r64, imm32
+    fuzz_emit8(prologue, 0x48 | (rd >> 3));
+    fuzz_emit8(prologue, 0xc7);
+    fuzz_emit8(prologue, 0xc0 | (rd & 7));
+    fuzz_emit_disp32(prologue, (int32_t)fuzz_rand());
+    break;
+  case 1: // alu r64, r64
+    fuzz_emit8(prologue, 0x48 | ((rs >> 3) << 2) | (rd >> 3));
+    fuzz_emit8(prologue, alu_opcodes[fuzz_rand_below(4)]);
+    fuzz_emit8(prologue, 0xc0 | ((rs & 7) << 3) | (rd & 7));
+    break;
+  }
+}
+
+static void fuzz_gen_cond_branch(fuzz_prologue_t *prologue) {
+  // jcc rel32
+  fuzz_emit8(prologue, 0x0f);
+  fuzz_emit8(prologue, 0x80 | fuzz_rand_below(16));
+  fuzz_emit_disp32(prologue, (int32_t)fuzz_rand_offset(FUZZ_FAR_OFFSET_MIN, FUZZ_FAR_OFFSET_MAX, 1));
+}
+
+static void fuzz_gen_exit_insn(fuzz_prologue_t *prologue) {
+  switch (fuzz_rand_below(3)) {
+  case 0: // jmp rel32
+    fuzz_emit8(prologue, 0xe9);
+    fuzz_emit_disp32(prologue, (int32_t)fuzz_rand_offset(FUZZ_FAR_OFFSET_MIN, FUZZ_FAR_OFFSET_MAX, 1));
+    break;
+  case 1: // jcc rel8 to the landing pad
+    fuzz_emit8(prologue, 0x70 | fuzz_rand_below(16));
+    fuzz_emit8(prologue, FUZZ_X64_LANDING_PAD_OFFSET);
+    break;
+  case 2: // jmp rel8 to the landing pad
+    fuzz_emit8(prologue, 0xeb);
+    fuzz_emit8(prologue, FUZZ_X64_LANDING_PAD_OFFSET);
+    break;
+  }
+}
+
+static void fuzz_gen_prologue(fuzz_prologue_t *prologue) {
+  prologue->size = 0;
+  int insn_count = 1 + fuzz_rand_below(FUZZ_MAX_INSN_COUNT - 1);
+  for (int i = 0; i < insn_count; i++) {
+    if (fuzz_rand_below(4) == 0)
+      fuzz_gen_cond_branch(prologue);
+    else
+      fuzz_gen_data_insn(prologue);
+  }
+  if (fuzz_rand_below(2))
+    fuzz_gen_exit_insn(prologue);
+}
+
+#endif
+
+#define FUZZ_REG_COUNT (sizeof(fuzz_regs) / sizeof(fuzz_regs[0]))
+
+// the original code page, with the x64 landing pad behind the prologue
+static void fuzz_build_orig_page(fuzz_prologue_t *prologue, uint8_t *page, size_t page_size) {
+  memset(page, 0, page_size);
+  memcpy(page, prologue->code, prologue->size);
+#if defined(TARGET_ARCH_X64)
+  // jmp [rip]; .quad FUZZ_X64_LANDING_ADDR
+  uint8_t *pad = page + prologue->size + FUZZ_X64_LANDING_PAD_OFFSET;
+  pad[0] = 0xff;
+  pad[1] = 0x25;
+  uint64_t landing_addr = FUZZ_X64_LANDING_ADDR;
+  memcpy(pad + 6, &landing_addr, sizeof(landing_addr));
+#endif
+}
+
+static void fuzz_init_regs(uint64_t *values) {
+  for (size_t i = 0; i < FUZZ_REG_COUNT; i++) {
+    values[i] = fuzz_rand();
+  }
+#if defined(TARGET_ARCH_X64)
+  // rsp only has to be equal on both sides
+  values[4] = 0x7fff0000;
+#endif
+}
+
+static void fuzz_emulate(UniconEmulator *emu, addr_t addr, addr_t end, uint64_t *values) {
+  for (size_t i = 0; i < FUZZ_REG_COUNT; i++) {
+    uint64_t value = values[i];
+    if (fuzz_regs[i].mask != ~0ULL) {
+      // flags register, keep the mode bits
+      uint64_t curr = (uint64_t)emu->readRegister(fuzz_regs[i].reg_id);
+      value = (curr & ~fuzz_regs[i].mask) | (value & fuzz_regs[i].mask);
+    }
+    emu->writeRegister(fuzz_regs[i].reg_id, (void *)value);
+  }
+  emu->writeRegister(fuzz_pc_reg, (void *)addr);
+
+  // stop at the until address only, the relocated code lives above the original end
+  emu->start_ = addr;
+  emu->end_ = (uintptr_t)-1;
+  emu->start(addr, end);
+}
+
+static void fuzz_report_failure(fuzz_prologue_t *prologue, uint64_t seed, int iteration, const char *reason) {
+  printf("[fuzz] %s mismatch: %s, seed: %llu, iteration: %d\n", fuzz_arch, reason, (unsigned long long)seed,
+         iteration);
+  printf("[fuzz] prologue:");
+  for (uint32_t i = 0; i < prologue->size; i++)
+    printf(" %02x", prologue->code[i]);
+  printf("\n");
+  abort();
+}
+
+// relocate at orig_addr and emulate both copies
+// @Return: false if the registers or the fault address differ
+static bool fuzz_check_prologue(fuzz_prologue_t *prologue, addr_t orig_addr, const char **reason) {
+  static uint8_t orig_page[0x1000];
+  fuzz_build_orig_page(prologue, orig_page, sizeof(orig_page));
+
+  auto origin = CodeMemBlock(orig_addr, prologue->size);
+  auto relocated = CodeMemBlock(fuzz_relocate_addr, 0x1000);
+  GenRelocateCodeAndBranch(prologue->code, &origin, &relocated);
+  if (relocated.addr == 0 || relocated.size == 0) {
+    *reason = "relocate failed";
+    return false;
+  }
+
+  // the relocated code branches back to orig_end, both runs stop there
+  addr_t orig_end = orig_addr + origin.size;
+
+  uint64_t values[FUZZ_REG_COUNT];
+  fuzz_init_regs(values);
+
+  auto orig_ue = new UniconEmulator(fuzz_arch);
+  auto relo_ue = new UniconEmulator(fuzz_arch);
+  orig_ue->trace_ = relo_ue->trace_ = false;
+
+  orig_ue->mapMemory(orig_addr, (char *)orig_page, sizeof(orig_page));
+  relo_ue->mapMemory(orig_addr, (char *)orig_page, sizeof(orig_page));
+  relo_ue->mapMemory(fuzz_relocate_addr, (char *)relocated.addr, relocated.size);
+
+  fuzz_emulate(orig_ue, orig_addr, orig_end, values);
+  fuzz_emulate(relo_ue, fuzz_relocate_addr, orig_end, values);
+
+  bool same = true;
+  if (orig_ue->getFaultAddr() != relo_ue->getFaultAddr()) {
+    *reason = "fault address";
+    same = false;
+  }
+  for (size_t i = 0; same && i < FUZZ_REG_COUNT; i++) {
+    uint64_t orig_value = (uint64_t)orig_ue->readRegister(fuzz_regs[i].reg_id);
+    uint64_t relo_value = (uint64_t)relo_ue->readRegister(fuzz_regs[i].reg_id);
+    if ((orig_value ^ relo_value) & fuzz_regs[i].mask) {
+      *reason = "register";
+      same = false;
+    }
+  }
+
+  delete orig_ue;
+  delete relo_ue;
+  return same;
+}
+
+static void fuzz_one(uint64_t seed, int iteration) {
+  fuzz_prologue_t prologue;
+  fuzz_gen_prologue(&prologue);
+  if (prologue.size == 0)
+    return;
+
+  const char *reason = nullptr;
+  if (!fuzz_check_prologue(&prologue, fuzz_orig_addr, &reason))
+    fuzz_report_failure(&prologue, seed, iteration, reason);
+
+  // same page offset at another address, exercises relocation results reused by prologue
+  if (!fuzz_check_prologue(&prologue, fuzz_orig_addr + 0x1000000, &reason))
+    fuzz_report_failure(&prologue, seed, iteration, reason);
+}
+
+static double fuzz_now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// relocations per second over a random corpus, relocation only
+static void fuzz_benchmark(int corpus_size, int rounds) {
+  auto corpus = new fuzz_prologue_t[corpus_size];
+  for (int i = 0; i < corpus_size; i++) {
+    do {
+      fuzz_gen_prologue(&corpus[i]);
+    } while (corpus[i].size == 0);
+  }
+
+  auto relocate_corpus = [&]() {
+    for (int i = 0; i < corpus_size; i++) {
+      auto origin = CodeMemBlock(fuzz_orig_addr, corpus[i].size);
+      auto relocated = CodeMemBlock(fuzz_relocate_addr, 0x1000);
+      GenRelocateCodeAndBranch(corpus[i].code, &origin, &relocated);
+    }
+  };
+
+  double start = fuzz_now();
+  relocate_corpus();
+  double first_round = fuzz_now() - start;
+
+  start = fuzz_now();
+  for (int round = 0; round < rounds; round++)
+    relocate_corpus();
+  double all_rounds = fuzz_now() - start;
+
+  printf("[bench] %s first round: %d relocations, %.0f relocations/s\n", fuzz_arch, corpus_size,
+         corpus_size / first_round);
+  printf("[bench] %s %d rounds: %d relocations, %.0f relocations/s\n", fuzz_arch, rounds, corpus_size * rounds,
+         corpus_size * rounds / all_rounds);
+
+  delete[] corpus;
+}
+
+#if defined(DOBBY_LIBFUZZER)
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  Logger::Shared()->setLogLevel(LOG_LEVEL_WARN);
+  set_global_arch(fuzz_arch);
+
+  // fnv-1a, the input picks the generator stream
+  uint64_t seed = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < size; i++)
+    seed = (seed ^ data[i]) * 0x100000001b3ULL;
+  fuzz_seed(seed);
+  fuzz_one(seed, 0);
+  return 0;
+}
+
+#else
+
+int main(int argc, char *argv[]) {
+  Logger::Shared()->setLogLevel(LOG_LEVEL_WARN);
+  set_global_arch(fuzz_arch);
+
+  int iterations = argc > 1 ? atoi(argv[1]) : 10000;
+  uint64_t seed = argc > 2 ? strtoull(argv[2], nullptr, 0) : (uint64_t)time(nullptr);
+  printf("[fuzz] %s iterations: %d, seed: %llu\n", fuzz_arch, iterations, (unsigned long long)seed);
+
+  fuzz_seed(seed);
+  for (int i = 0; i < iterations; i++)
+    fuzz_one(seed, i);
+  printf("[fuzz] %s %d prologues ok\n", fuzz_arch, iterations);
+
+  fuzz_benchmark(256, 64);
+  return 0;
+}
+
+#endif
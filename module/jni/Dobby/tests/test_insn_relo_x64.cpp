@@ -14,6 +14,13 @@ int main() {
   // jz 0x20
   check_insn_relo("\x39\xc0\x74\x1c", 4, false, UC_X86_REG_IP, nullptr);
 
+  // cmp eax, eax
+  // jz -0x4000
+  check_insn_relo("\x39\xc0\x0f\x84\xfa\xbf\xff\xff", 8, false, UC_X86_REG_IP, nullptr);
+  // cmp eax, eax
+  // jz 0x4000
+  check_insn_relo("\x39\xc0\x0f\x84\xfa\x3f\x00\x00", 8, false, UC_X86_REG_IP, nullptr);
+
   // jmp -0x20
   check_insn_relo("\xeb\xde", 2, false, UC_X86_REG_IP, nullptr);
   // jmp 0x20
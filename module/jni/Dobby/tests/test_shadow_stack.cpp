@@ -0,0 +1,133 @@
+#include "dobby.h"
+
+#include <pthread.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define LOG(fmt, ...) printf("[test_shadow_stack] " fmt, ##__VA_ARGS__)
+
+#if defined(__x86_64__)
+#define CTX_ARG0(ctx) ((ctx)->general.regs.rdi)
+#define CTX_RET(ctx) ((ctx)->general.regs.rax)
+#elif defined(__arm64__) || defined(__aarch64__)
+#define CTX_ARG0(ctx) ((ctx)->general.x[0])
+#define CTX_RET(ctx) ((ctx)->general.x[0])
+#endif
+
+// frames the shadow stack holds per thread, see ThreadSupport.h
+#define SHADOW_STACK_DEPTH 64
+
+__attribute__((noinline)) int target(int x) {
+  volatile int y = x * 3;
+  if (x > 0)
+    y += target(x - 1);
+  return y + 1;
+}
+
+static jmp_buf jumper_buf;
+
+__attribute__((noinline)) int jumper(int x) {
+  volatile int y = x;
+  if (x < 0)
+    return y;
+  if (x == 0)
+    longjmp(jumper_buf, 1);
+  return jumper(x - 1) + y;
+}
+
+__attribute__((noinline)) static void jump_once() {
+  if (!setjmp(jumper_buf))
+    jumper(3);
+}
+
+static volatile int enters, leaves, mismatches, jumper_enters, jumper_leaves;
+static volatile int outer_ret;
+
+static void target_enter(void *, DobbyRegisterContext *ctx, DobbyInstrumentContext *user_ctx) {
+  enters++;
+  user_ctx->slots[0] = CTX_ARG0(ctx);
+  user_ctx->slots[1] = (uintptr_t)&target;
+}
+
+static void target_leave(void *address, DobbyRegisterContext *ctx, DobbyInstrumentContext *user_ctx) {
+  leaves++;
+  if (address != (void *)&target || user_ctx->slots[1] != (uintptr_t)&target)
+    mismatches++;
+  if (user_ctx->slots[0] == 5)
+    outer_ret = (int)CTX_RET(ctx);
+}
+
+static void jumper_enter(void *, DobbyRegisterContext *, DobbyInstrumentContext *) {
+  jumper_enters++;
+}
+
+static void jumper_leave(void *, DobbyRegisterContext *, DobbyInstrumentContext *) {
+  jumper_leaves++;
+}
+
+static void reset() {
+  enters = leaves = mismatches = jumper_enters = jumper_leaves = 0;
+  outer_ret = 0;
+}
+
+static int failures = 0;
+
+static void check(bool ok, const char *what) {
+  LOG("%s: %s\n", what, ok ? "ok" : "FAILED");
+  if (!ok)
+    failures++;
+}
+
+static void *thread_target(void *) {
+  return (void *)(intptr_t)target(3);
+}
+
+// the leave handler sees the slots of its own enter and the return value
+void test_leave_dispatch(int expect) {
+  reset();
+  int v = target(5);
+  check(v == expect && outer_ret == expect, "return value");
+  check(enters == 6 && leaves == 6 && mismatches == 0, "leave per enter");
+
+  reset();
+  pthread_t thread;
+  void *ret;
+  pthread_create(&thread, nullptr, thread_target, nullptr);
+  pthread_join(thread, &ret);
+  check((intptr_t)ret == target(3) && mismatches == 0, "leave on another thread");
+}
+
+// calls deeper than the shadow stack run without a leave, the frames below still get theirs
+void test_overflow() {
+  reset();
+  target(100);
+  check(enters == 101 && leaves == SHADOW_STACK_DEPTH && mismatches == 0, "overflow");
+}
+
+// frames skipped by a longjmp are pruned, not leaked into later calls
+void test_longjmp() {
+  reset();
+  for (int i = 0; i < 40; i++)
+    jump_once();
+  check(jumper_enters == 160 && jumper_leaves == 0, "longjmp skips leaves");
+
+  reset();
+  target(SHADOW_STACK_DEPTH - 1);
+  check(enters == SHADOW_STACK_DEPTH && leaves == SHADOW_STACK_DEPTH && mismatches == 0, "longjmp frames pruned");
+}
+
+int main() {
+  int expect = target(5);
+  if (DobbyInstrumentEnterLeave((void *)target, target_enter, target_leave) != 0 ||
+      DobbyInstrumentEnterLeave((void *)jumper, jumper_enter, jumper_leave) != 0) {
+    LOG("instrument failed\n");
+    return 1;
+  }
+
+  test_leave_dispatch(expect);
+  test_overflow();
+  test_longjmp();
+
+  return failures ? 1 : 0;
+}
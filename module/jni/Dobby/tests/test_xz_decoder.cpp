@@ -0,0 +1,146 @@
+#include "SymbolResolver/elf/xz_decoder.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+// .gnu_debugdata of a shared library, the xz of its local symbols added by `objcopy --add-section`,
+// it decompresses to a 2544 bytes elf with the local symbol mdi_secret
+// clang-format off
+static const uint8_t gnu_debugdata[] = {
+  0xfd, 0x37, 0x7a, 0x58, 0x5a, 0x00, 0x00, 0x04, 0xe6, 0xd6, 0xb4, 0x46, 0x04, 0xc0, 0xba, 0x04,
+  0xf0, 0x13, 0x21, 0x01, 0x16, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x90, 0x9f, 0x74, 0xf8,
+  0xe0, 0x09, 0xef, 0x02, 0x32, 0x5d, 0x00, 0x3f, 0x91, 0x45, 0x84, 0x68, 0x3d, 0x89, 0xa6, 0xda,
+  0x8a, 0xe1, 0x83, 0x32, 0x4e, 0xf1, 0xed, 0xef, 0x67, 0x18, 0x2a, 0xb4, 0x78, 0x6d, 0x2b, 0x38,
+  0xea, 0x45, 0xc6, 0x8c, 0x98, 0x64, 0xb9, 0xce, 0x93, 0x00, 0x31, 0x1d, 0xa5, 0xae, 0xbc, 0x09,
+  0xb7, 0x6a, 0x5b, 0xa7, 0xaf, 0x88, 0x25, 0xe4, 0x1a, 0x9a, 0x6c, 0x01, 0x48, 0x3b, 0x23, 0x2d,
+  0xe3, 0x2b, 0xa8, 0xa8, 0xe1, 0x15, 0xea, 0x69, 0xf6, 0xef, 0x4e, 0xf7, 0x2a, 0x07, 0xd8, 0x64,
+  0x27, 0x61, 0x54, 0xa6, 0x40, 0xa5, 0xfb, 0xef, 0x7d, 0x39, 0xe2, 0xc6, 0x53, 0x82, 0xb5, 0x7a,
+  0xd6, 0x23, 0xeb, 0x53, 0xc0, 0xb0, 0x21, 0x34, 0xa5, 0x2d, 0xe6, 0xb9, 0x52, 0x51, 0xee, 0xc5,
+  0x5d, 0x46, 0x77, 0x31, 0xf0, 0x6c, 0x0c, 0xba, 0xbf, 0xd6, 0x32, 0x7c, 0x47, 0x2c, 0x87, 0x7b,
+  0x16, 0xbe, 0x78, 0xd3, 0x83, 0xb2, 0xef, 0xb8, 0x6f, 0x57, 0x4b, 0x65, 0x52, 0x20, 0xb6, 0xca,
+  0x91, 0x19, 0x40, 0x05, 0x4b, 0xc5, 0x38, 0x94, 0xa9, 0xb3, 0x27, 0x88, 0xd9, 0x43, 0xc7, 0x06,
+  0x71, 0x76, 0x0c, 0xe8, 0x0e, 0x3f, 0xb7, 0x02, 0x17, 0xd6, 0x1d, 0xff, 0x49, 0x75, 0x51, 0x7f,
+  0x8e, 0xbe, 0x18, 0x4b, 0x09, 0x71, 0x52, 0xfa, 0xd1, 0x98, 0x99, 0xc3, 0x58, 0xe4, 0x5a, 0x98,
+  0x40, 0xe6, 0x60, 0xfa, 0x34, 0x42, 0xb0, 0xad, 0x4c, 0x75, 0xee, 0x2e, 0x08, 0x1a, 0x3c, 0x40,
+  0x2f, 0xcb, 0xb1, 0xaf, 0x21, 0x16, 0xb3, 0x92, 0x1f, 0x9d, 0x7c, 0x0b, 0x99, 0x0c, 0x3d, 0xed,
+  0x75, 0x16, 0x5b, 0xf4, 0x95, 0x8a, 0x0a, 0x66, 0xa1, 0xf9, 0xe4, 0x70, 0xff, 0xd5, 0x6e, 0x26,
+  0xe6, 0x48, 0x13, 0x20, 0x84, 0xb8, 0x5d, 0x8e, 0x23, 0x7f, 0xab, 0xb9, 0xc6, 0xbc, 0x6d, 0x24,
+  0x4c, 0x15, 0xc4, 0x8e, 0x4e, 0xb2, 0x75, 0xfa, 0x6f, 0x33, 0xb1, 0x7f, 0xa8, 0x2c, 0x2c, 0xb4,
+  0xfd, 0x26, 0x10, 0x46, 0x6b, 0x80, 0x59, 0xf1, 0xc7, 0x94, 0xf1, 0x0c, 0x69, 0x54, 0xed, 0x51,
+  0xfa, 0x29, 0x9b, 0xb4, 0x0c, 0xf5, 0xc9, 0xf5, 0xf9, 0x93, 0x8e, 0x2e, 0xed, 0xb2, 0xab, 0x44,
+  0x90, 0xef, 0xca, 0x7a, 0x71, 0x57, 0x3f, 0x79, 0x01, 0x5f, 0x5b, 0x9d, 0x64, 0x80, 0xdd, 0x03,
+  0x9b, 0xf3, 0x51, 0xc5, 0x3e, 0x2a, 0x8a, 0x12, 0x8d, 0x79, 0xd7, 0x86, 0x60, 0x14, 0x97, 0xa1,
+  0x79, 0x27, 0xdc, 0x1b, 0x2f, 0xd3, 0x9b, 0x71, 0xae, 0x45, 0x79, 0xb2, 0x7e, 0x3e, 0x1c, 0xda,
+  0x92, 0xc0, 0x6b, 0x41, 0xc0, 0x81, 0xb7, 0xd4, 0xaa, 0x61, 0x36, 0x0c, 0xee, 0x09, 0x38, 0x38,
+  0x73, 0xdb, 0x05, 0xa9, 0xeb, 0x52, 0x4b, 0x55, 0x92, 0x84, 0xee, 0x3a, 0x67, 0xd5, 0x7a, 0x98,
+  0x03, 0x23, 0x28, 0x76, 0x3d, 0x88, 0x76, 0xc3, 0xf7, 0x3d, 0xfb, 0x1a, 0x27, 0x13, 0x3d, 0x34,
+  0xda, 0x59, 0xcf, 0x5b, 0x34, 0xbe, 0x6c, 0x51, 0x6a, 0xab, 0xec, 0x8c, 0x6e, 0x39, 0xec, 0x89,
+  0x3f, 0x58, 0x12, 0xbf, 0x07, 0xf3, 0x58, 0xf7, 0x78, 0xbb, 0x58, 0xad, 0x88, 0x37, 0xa6, 0xc6,
+  0x54, 0x98, 0xb9, 0xf1, 0x31, 0xcc, 0x4d, 0x0c, 0x2d, 0xa6, 0x0b, 0x71, 0xe3, 0x24, 0x47, 0x38,
+  0x4c, 0x18, 0xe9, 0x70, 0x95, 0x85, 0x04, 0xda, 0x45, 0x34, 0xf5, 0x26, 0xe7, 0xe1, 0xfc, 0xad,
+  0x66, 0xd5, 0xb2, 0xda, 0x93, 0xb8, 0x40, 0x2e, 0x5f, 0x82, 0x1a, 0xd0, 0x35, 0x0e, 0xc4, 0xb0,
+  0x49, 0x86, 0x3d, 0xea, 0xee, 0x70, 0x91, 0x2d, 0x06, 0xc7, 0x3e, 0x5f, 0x06, 0x04, 0xf5, 0xc9,
+  0x7e, 0x9f, 0xd2, 0x1d, 0x44, 0x18, 0x23, 0xd1, 0xa5, 0x0a, 0x2e, 0x2d, 0x29, 0xe4, 0x5a, 0x07,
+  0x0b, 0x03, 0x12, 0x69, 0xdf, 0xb9, 0xa1, 0x25, 0x48, 0x6c, 0x0e, 0xb4, 0x3a, 0xd5, 0x2d, 0xd1,
+  0x68, 0xe6, 0xde, 0x81, 0x1b, 0xdf, 0x9a, 0x68, 0xf0, 0xd0, 0x4f, 0x8a, 0x76, 0xe6, 0xad, 0x05,
+  0x4a, 0xf3, 0xae, 0x05, 0x19, 0xaf, 0x73, 0xe8, 0x3c, 0xa7, 0xbc, 0x24, 0xc3, 0x97, 0xe4, 0x87,
+  0x6d, 0x0c, 0x3a, 0xbd, 0x30, 0x05, 0x78, 0x12, 0x87, 0x00, 0x00, 0x00, 0xb2, 0xb2, 0x29, 0xe5,
+  0xf3, 0xc3, 0xf8, 0xaf, 0x00, 0x01, 0xd6, 0x04, 0xf0, 0x13, 0x00, 0x00, 0xa1, 0x86, 0xb4, 0x6a,
+  0xb1, 0xc4, 0x67, 0xfb, 0x02, 0x00, 0x00, 0x00, 0x00, 0x04, 0x59, 0x5a,
+};
+// clang-format on
+
+#define GNU_DEBUGDATA_ELF_SIZE 2544
+#define GNU_DEBUGDATA_ELF_HASH 0x6e85a992
+
+static uint32_t fnv1a(const uint8_t *data, size_t size) {
+  uint32_t hash = 0x811c9dc5;
+  for (size_t i = 0; i < size; i++)
+    hash = (hash ^ data[i]) * 0x01000193;
+  return hash;
+}
+
+static int check_decode() {
+  std::vector<uint8_t> out;
+  if (!xz_decompress(gnu_debugdata, sizeof(gnu_debugdata), out)) {
+    printf("[-] decode failed\n");
+    return 1;
+  }
+  if (out.size() != GNU_DEBUGDATA_ELF_SIZE || fnv1a(out.data(), out.size()) != GNU_DEBUGDATA_ELF_HASH) {
+    printf("[-] decode size %zu (expect %d), hash 0x%x\n", out.size(), GNU_DEBUGDATA_ELF_SIZE,
+           fnv1a(out.data(), out.size()));
+    return 1;
+  }
+  if (memcmp(out.data(), "\x7f" "ELF", 4) != 0 || !memmem(out.data(), out.size(), "mdi_secret", 11)) {
+    printf("[-] decode is not the expected elf\n");
+    return 1;
+  }
+  return 0;
+}
+
+// every prefix of the stream misses its end, the decoder must reject it without reading past the input
+static int check_truncated() {
+  int failed = 0;
+  for (size_t size = 0; size < sizeof(gnu_debugdata); size++) {
+    std::vector<uint8_t> in(gnu_debugdata, gnu_debugdata + size);
+    std::vector<uint8_t> out;
+    if (xz_decompress(in.data(), in.size(), out)) {
+      printf("[-] truncated to %zu bytes decoded\n", size);
+      failed++;
+    }
+  }
+  return failed;
+}
+
+// corrupt stream header and block header fields are rejected
+static int check_corrupt() {
+  typedef struct {
+    size_t offset;
+    uint8_t value;
+    const char *desc;
+  } corrupt_case_t;
+  static const corrupt_case_t cases[] = {
+    {0, 0x00, "stream magic"},
+    {7, 0x10, "reserved check type"},
+    {13, 0xc1, "two filters"},
+    {18, 0x04, "x86 bcj filter"},
+    {19, 0x02, "lzma2 properties size"},
+    {32, 0x80, "lzma chunk without dictionary reset"},
+    {37, 0xff, "lzma properties"},
+    {sizeof(gnu_debugdata) - 1, 0x00, "stream footer magic"},
+  };
+
+  int failed = 0;
+  for (auto &c : cases) {
+    std::vector<uint8_t> in(gnu_debugdata, gnu_debugdata + sizeof(gnu_debugdata));
+    in[c.offset] = c.value;
+    std::vector<uint8_t> out;
+    if (xz_decompress(in.data(), in.size(), out)) {
+      printf("[-] corrupt %s decoded\n", c.desc);
+      failed++;
+    }
+  }
+
+  // without integrity checks a flipped payload byte may still decode, it must only stay within the input and output
+  for (size_t offset = 0; offset < sizeof(gnu_debugdata); offset++) {
+    std::vector<uint8_t> in(gnu_debugdata, gnu_debugdata + sizeof(gnu_debugdata));
+    in[offset] ^= 0xff;
+    std::vector<uint8_t> out;
+    xz_decompress(in.data(), in.size(), out);
+  }
+  return failed;
+}
+
+int main() {
+  int failed = check_decode();
+  failed += check_truncated();
+  failed += check_corrupt();
+  if (failed) {
+    printf("[-] %d xz decoder failures\n", failed);
+    return 1;
+  }
+  printf("[+] xz decoder ok\n");
+  return 0;
+}
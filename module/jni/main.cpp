@@ -137,21 +137,25 @@ private:
         }
     }
 
-    void installSystemPropertyHook() {
-        LOGI("Installing hook for __system_property_get in PID %d", getpid());
+    void *systemPropertyGetAddr = nullptr;
+
+    // resolve and relocate in pre-specialize, post-specialize only pays for the patch.
+    // onLoad runs in every app forked from zygote, only the target app prepares the hook
+    void prepareSystemPropertyHook() {
+        LOGI("Preparing hook for __system_property_get in PID %d", getpid());
 
         void *target_addr = dlsym(RTLD_DEFAULT, "__system_property_get");
         if (target_addr) {
             LOGI("Found __system_property_get at address: %p", target_addr);
-            int ret = DobbyHook(
+            int ret = DobbyPrepare(
                 target_addr,
                 (dobby_dummy_func_t)my_system_property_get,
                 (dobby_dummy_func_t *)&orig_system_property_get
             );
             if (ret == 0) {
-                LOGI("DobbyHook for __system_property_get installed successfully");
+                systemPropertyGetAddr = target_addr;
             } else {
-                LOGE("DobbyHook failed with error code: %d", ret);
+                LOGE("DobbyPrepare failed with error code: %d", ret);
                 orig_system_property_get = nullptr;
             }
         } else {
@@ -160,6 +164,21 @@ private:
         }
     }
 
+    void installSystemPropertyHook() {
+        if (!systemPropertyGetAddr) {
+            LOGE("Hook for __system_property_get was not prepared");
+            return;
+        }
+
+        int ret = DobbyCommit(systemPropertyGetAddr);
+        if (ret == 0) {
+            LOGI("DobbyHook for __system_property_get installed successfully");
+        } else {
+            LOGE("DobbyCommit failed with error code: %d", ret);
+            orig_system_property_get = nullptr;
+        }
+    }
+
 public:
     void onLoad(Api *api, JNIEnv *env) override {
         this->api = api;
@@ -207,6 +226,7 @@ public:
         if (this->isTargetApp) {
             api->setOption(zygisk::FORCE_DENYLIST_UNMOUNT);
             LOGI("Pre-specialize: Enabling FORCE_DENYLIST_UNMOUNT for target app");
+            prepareSystemPropertyHook();
         } else {
             api->setOption(zygisk::DLCLOSE_MODULE_LIBRARY);
         }